@@ -38,6 +38,7 @@ enum Kind {
   EXPR_MAP,     // {K1: V1, K2: V2}
   EXPR_TUPLE,   // (<EXPR>..)
   EXPR_INDEX,   // EXPR[EXPR]
+  EXPR_SLICE,   // EXPR[EXPR:EXPR]
   EXPR_NEW,
   // statement
   STMT_EXPR,      // EXPR
@@ -45,6 +46,7 @@ enum Kind {
   STMT_BLOCK,     // BLOCK
   STMT_IF,        // IF
   STMT_FOR,       // FOR
+  STMT_FOR_IN,    // FOR IN
   STMT_AOP,       // AOP
   STMT_OUT,       // OUT
   STMT_GO,        // GO
@@ -57,7 +59,9 @@ enum Kind {
   STMT_ENUM,      // ENUM
   STMT_INHERIT,   // <- <name> + <name>..
   STMT_INTERFACE, // INTERFACE
-  STMT_DEL        // DEL
+  STMT_DEL,       // DEL
+  STMT_YIELD,     // YIELD
+  STMT_PAR        // PARALLEL FOR IN
 };
 
 // K1: V1 | K1 + K2: V2
@@ -328,6 +332,24 @@ public:
   Kind kind() override { return EXPR_INDEX; }
 };
 
+// EXPR[<EXPR>:<EXPR>]
+class SliceExpr : public Expr {
+public:
+  Expr *left;
+  Expr *lo; // nullptr if from the first
+  Expr *hi; // nullptr if to the end
+
+  explicit SliceExpr(Expr *l, Expr *lo, Expr *hi) : left(l), lo(lo), hi(hi) {}
+
+  std::string stringer() override {
+    return "<SE L=" + left->stringer() +
+           " LO=" + (lo == nullptr ? "NONE" : lo->stringer()) +
+           " HI=" + (hi == nullptr ? "NONE" : hi->stringer()) + ">";
+  }
+
+  Kind kind() override { return EXPR_SLICE; }
+};
+
 // new <name>{K1: V1, K2: V2}
 class NewExpr : public Expr {
 public:
@@ -528,6 +550,78 @@ public:
   Kind kind() override { return STMT_FOR; }
 };
 
+/**
+ * for <name> in <expr> | for <name>, <name> in <expr>
+ *     <block>
+ * end
+ */
+class ForInStmt : public Stmt {
+public:
+  std::vector<token::Token> names; // element, or index and element
+  Expr *expr;                      // array, map, string or tuple
+
+  BlockStmt *block; // block
+
+  explicit ForInStmt(std::vector<token::Token> names, Expr *expr,
+                     BlockStmt *block) {
+    this->names = std::move(names);
+    this->expr = expr;
+    this->block = block;
+  }
+
+  std::string stringer() override {
+    std::stringstream str;
+
+    str << "<ForInStmt NAMES=";
+    for (auto &i : names)
+      str << "'" << i.literal << "' ";
+    str << "E=" << expr->stringer() << " B=" << block->stringer() << ">";
+    return str.str();
+  }
+
+  Kind kind() override { return STMT_FOR_IN; }
+};
+
+/**
+ * par <name> in <expr> -> <op> <name>, ..
+ *     <block>
+ * end
+ */
+class ParStmt : public Stmt {
+public:
+  std::vector<token::Token> names; // index, or index and element
+  Expr *expr;                      // count of indexes or array
+
+  // operator and name of reductions, + < or >
+  std::vector<std::pair<token::Token, token::Token>> reduce;
+
+  BlockStmt *block; // block
+
+  explicit ParStmt(std::vector<token::Token> names, Expr *expr,
+                   std::vector<std::pair<token::Token, token::Token>> reduce,
+                   BlockStmt *block) {
+    this->names = std::move(names);
+    this->expr = expr;
+    this->reduce = std::move(reduce);
+    this->block = block;
+  }
+
+  std::string stringer() override {
+    std::stringstream str;
+
+    str << "<ParStmt NAMES=";
+    for (auto &i : names)
+      str << "'" << i.literal << "' ";
+    str << "E=" << expr->stringer() << " R=";
+    for (auto &i : reduce)
+      str << i.first.literal << i.second.literal << " ";
+    str << "B=" << block->stringer() << ">";
+    return str.str();
+  }
+
+  Kind kind() override { return STMT_PAR; }
+};
+
 /**
  * aop <expr> | ->
  *  <block>
@@ -841,6 +935,20 @@ public:
 
   Kind kind() override { return STMT_DEL; }
 };
+
+// yield <expr>
+class YieldStmt : public Stmt {
+public:
+  Expr *expr;
+
+  explicit YieldStmt(Expr *e) : expr(e) {}
+
+  std::string stringer() override {
+    return "<YieldStmt { Expr=" + expr->stringer() + " }>";
+  }
+
+  Kind kind() override { return STMT_YIELD; }
+};
 }; // namespace ast
 
 #endif
\ No newline at end of file
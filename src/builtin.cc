@@ -12,79 +12,64 @@
 //          https://www.drift-lang.fun/
 //
 
-#if defined(__linux__) || defined(__APPLE__)
-#include <unistd.h> // LINUX
-
-#elif defined(_WIN32)
-#include <windows.h> // WINDOWS
-
-#endif
+#include <algorithm>
 
 #include "builtin.h"
 
 // throw an exception
 void error(std::string m) {
-  State *state = new State;
+  State state;
 
-  state->filePath = "BUILTIN";
-  state->kind = exp::RUNTIME_ERROR;
-  state->message = m;
-  state->line = -1;
+  state.filePath = "BUILTIN";
+  state.kind = exp::RUNTIME_ERROR;
+  state.message = m;
+  state.line = -1;
 
-  throw exp::Exp(state);
+  throw exp::Exp(&state);
 }
 
 // print to screen
-void puts(object::Object *obj, Frame *) {
-  object::Func *f = static_cast<object::Func *>(obj);
-
+void puts(Args &args, Frame *) {
   // new line
-  if (f->builtin.empty()) {
+  if (args.empty()) {
     std::cout << std::endl;
     return;
   }
 
-  for (std::vector<object::Object *>::reverse_iterator iter =
-           f->builtin.rbegin();
-       iter != f->builtin.rend(); iter++) {
+  for (Args::reverse_iterator iter = args.rbegin(); iter != args.rend();
+       iter++) {
     std::cout << (*iter)->stringer() << std::endl;
   }
 }
 
 // print to screen but no new line
-void put(object::Object *obj, Frame *) {
-  object::Func *f = static_cast<object::Func *>(obj);
-  for (std::vector<object::Object *>::reverse_iterator iter =
-           f->builtin.rbegin();
-       iter != f->builtin.rend(); iter++) {
+void put(Args &args, Frame *) {
+  for (Args::reverse_iterator iter = args.rbegin(); iter != args.rend();
+       iter++) {
     std::cout << (*iter)->stringer() << "\t";
   }
 }
 
 // print to screen and end new line
-void putl(object::Object *obj, Frame *) {
-  object::Func *f = static_cast<object::Func *>(obj);
-  for (std::vector<object::Object *>::reverse_iterator iter =
-           f->builtin.rbegin();
-       iter != f->builtin.rend(); iter++) {
+void putl(Args &args, Frame *) {
+  for (Args::reverse_iterator iter = args.rbegin(); iter != args.rend();
+       iter++) {
     std::cout << (*iter)->stringer() << "\t";
   }
   std::cout << std::endl;
 }
 
 // return the length of object
-void len(object::Object *obj, Frame *f) {
-  object::Func *fu = static_cast<object::Func *>(obj);
-
-  if (fu->builtin.empty() || fu->builtin.size() > 1)
+void len(Args &args, Frame *f) {
+  if (args.empty() || args.size() > 1)
     error("the <len> function receives one object");
 
-  obj = fu->builtin.front();
+  object::Object *obj = args.front();
 
   switch (obj->kind()) {
   case object::ARRAY:
     f->data.push(
-        new object::Int(static_cast<object::Array *>(obj)->elements.size()));
+        new object::Int(static_cast<object::Array *>(obj)->size()));
     break;
   case object::TUPLE:
     f->data.push(
@@ -107,32 +92,13 @@ void len(object::Object *obj, Frame *f) {
   }
 }
 
-// sleep time
-void bsleep(object::Object *obj, Frame *) {
-  object::Func *fu = static_cast<object::Func *>(obj);
-
-  if (fu->builtin.empty() || fu->builtin.size() > 1 ||
-      fu->builtin.front()->kind() != object::INT)
-    error("the <sleep> function receives one <int> object");
-
-  object::Int *i = static_cast<object::Int *>(fu->builtin.front());
-
-#if defined(__linux__) || defined(__APPLE__)
-  sleep(i->value);
-#elif defined(_WIN32)
-  Sleep(i->value);
-#endif
-}
-
 // type
-void type(object::Object *obj, Frame *f) {
-  object::Func *fu = static_cast<object::Func *>(obj);
-
-  if (fu->builtin.empty() || fu->builtin.size() > 1)
+void type(Args &args, Frame *f) {
+  if (args.empty() || args.size() > 1)
     error("the <type> function receives one object");
 
 #define PUSH(obj) f->data.push(obj)
-  switch (fu->builtin.front()->kind()) {
+  switch (args.front()->kind()) {
   case object::INT:
     PUSH(new object::Str("int"));
     break;
@@ -166,42 +132,267 @@ void type(object::Object *obj, Frame *f) {
   case object::WHOLE:
     PUSH(new object::Str("whole"));
     break;
+  case object::CHAN:
+    PUSH(new object::Str("chan"));
+    break;
   }
 #undef PUSH
 }
 
 // generate a random string with length
-void randomStr(object::Object *obj, Frame *f) {
-  object::Func *fu = static_cast<object::Func *>(obj);
-
-  if (fu->builtin.empty() || fu->builtin.size() != 2)
+void randomStr(Args &args, Frame *f) {
+  if (args.empty() || args.size() != 2)
     error("the <randomStr> function receives two object");
 
-  object::Object *x = fu->builtin.back(); // length
-  fu->builtin.pop_back();
+  object::Object *x = args.back(); // length
+  args.pop_back();
 
-  object::Object *y = fu->builtin.back(); // is upper
+  object::Object *y = args.back(); // is upper
 
   if (x->kind() != object::INT || y->kind() != object::BOOL)
     error("error arguments for <randomStr> function need (<Int>, <Bool>) to "
           "call");
 
-  object::Int *i = static_cast<object::Int *>(fu->builtin.front());
+  object::Int *i = static_cast<object::Int *>(args.front());
 
   f->data.push(new object::Str(
       strRand(static_cast<object::Int *>(x)->value,
               static_cast<object::Bool *>(y)->value))); // GENERATE
 }
 
-constexpr int l = 7; // length of builtin names
+// numbers of array in contiguous storage
+struct Numbers {
+  bool real = false; // float
+  int n = 0;         // count
+
+  const int *ints = nullptr;
+  const double *floats = nullptr;
+
+  std::vector<int> is;    // unboxed of objects
+  std::vector<double> fs; // unboxed of objects
+};
+
+// unbox array of numbers, packed storage is used as it is
+static void unbox(std::string name, object::Object *obj, Numbers *x) {
+  if (obj->kind() != object::ARRAY)
+    error("the <" + name + "> function receives array of numbers");
+  object::Array *a = static_cast<object::Array *>(obj);
+
+  x->n = a->size();
+  // storage of slice is the one of array viewed
+  object::Array *s = a->view != nullptr ? a->view : a;
+  int from = a->view != nullptr ? a->from : 0;
+
+  switch (s->packed) {
+  case object::P_INT:
+    x->ints = s->ints.data() + from;
+    return;
+  case object::P_FLOAT:
+    x->floats = s->floats.data() + from;
+    x->real = true;
+    return;
+  case object::P_CHAR:
+    error("the <" + name + "> function receives array of numbers");
+  }
+
+  auto begin = s->elements.begin() + from;
+  auto end = begin + x->n;
+
+  for (auto it = begin; it != end; it++) {
+    object::Object *i = *it;
+    if (i->kind() == object::FLOAT)
+      x->real = true;
+    else if (i->kind() != object::INT)
+      error("the <" + name + "> function receives array of numbers");
+  }
+  for (auto it = begin; it != end; it++) {
+    object::Object *i = *it;
+    if (!x->real)
+      x->is.push_back(static_cast<object::Int *>(i)->value);
+    else if (i->kind() == object::INT)
+      x->fs.push_back(static_cast<object::Int *>(i)->value);
+    else
+      x->fs.push_back(static_cast<object::Float *>(i)->value);
+  }
+  x->ints = x->is.data();
+  x->floats = x->fs.data();
+}
+
+// numbers as floats
+static void real(Numbers *x) {
+  if (x->real)
+    return;
+  x->fs.assign(x->ints, x->ints + x->n);
+  x->floats = x->fs.data();
+  x->real = true;
+}
+
+// number argument of vector function
+static object::Object *number(std::string name, object::Object *obj) {
+  if (obj->kind() != object::INT && obj->kind() != object::FLOAT)
+    error("the <" + name + "> function receives number");
+  return obj;
+}
+
+// value of number argument
+static double numberValue(object::Object *obj) {
+  if (obj->kind() == object::INT)
+    return static_cast<object::Int *>(obj)->value;
+  return static_cast<object::Float *>(obj)->value;
+}
+
+// check arguments of vector function, and put them in order
+static void vecArgs(Args &args, std::string name, int count) {
+  if (args.size() != count)
+    error("the <" + name + "> function receives " + std::to_string(count) +
+          " object");
+  std::reverse(args.begin(), args.end());
+}
+
+// sum of array
+void vecSum(Args &args, Frame *f) {
+  Numbers x;
+  vecArgs(args, "vecSum", 1);
+  unbox("vecSum", args.at(0), &x);
+
+  if (x.real)
+    f->data.push(new object::Float(vec::sum(x.floats, x.n)));
+  else
+    f->data.push(new object::Int(vec::sum(x.ints, x.n)));
+}
+
+// minimum or maximum of array
+static void vecMinMax(Args &args, Frame *f, std::string name, bool less) {
+  Numbers x;
+  vecArgs(args, name, 1);
+  unbox(name, args.at(0), &x);
+
+  if (x.n == 0)
+    error("empty element of array");
+  if (x.real)
+    f->data.push(new object::Float(less ? vec::min(x.floats, x.n)
+                                        : vec::max(x.floats, x.n)));
+  else
+    f->data.push(new object::Int(less ? vec::min(x.ints, x.n)
+                                      : vec::max(x.ints, x.n)));
+}
+
+// minimum of array
+void vecMin(Args &args, Frame *f) { vecMinMax(args, f, "vecMin", true); }
+
+// maximum of array
+void vecMax(Args &args, Frame *f) { vecMinMax(args, f, "vecMax", false); }
+
+// sum of products of two arrays
+void vecDot(Args &args, Frame *f) {
+  vecArgs(args, "vecDot", 2);
+  Numbers x, y;
+  unbox("vecDot", args.at(0), &x);
+  unbox("vecDot", args.at(1), &y);
+
+  if (x.n != y.n)
+    error("the <vecDot> function receives arrays of same length");
+  if (x.real || y.real) {
+    real(&x);
+    real(&y);
+    f->data.push(new object::Float(vec::dot(x.floats, y.floats, x.n)));
+  } else
+    f->data.push(new object::Int(vec::dot(x.ints, y.ints, x.n)));
+}
+
+// new array of each element multiplied by number
+void vecScale(Args &args, Frame *f) {
+  vecArgs(args, "vecScale", 2);
+  Numbers x;
+  unbox("vecScale", args.at(0), &x);
+  object::Object *k = number("vecScale", args.at(1));
+
+  object::Array *a = new object::Array;
+  if (x.real || k->kind() == object::FLOAT) {
+    real(&x);
+    a->packed = object::P_FLOAT;
+    a->floats.resize(x.n);
+    vec::scale(x.floats, numberValue(k), a->floats.data(), x.n);
+  } else {
+    a->packed = object::P_INT;
+    a->ints.resize(x.n);
+    vec::scale(x.ints, static_cast<object::Int *>(k)->value, a->ints.data(),
+               x.n);
+  }
+  f->data.push(a);
+}
+
+// new array of sums of elements of two arrays
+void vecAdd(Args &args, Frame *f) {
+  vecArgs(args, "vecAdd", 2);
+  Numbers x, y;
+  unbox("vecAdd", args.at(0), &x);
+  unbox("vecAdd", args.at(1), &y);
+
+  if (x.n != y.n)
+    error("the <vecAdd> function receives arrays of same length");
+
+  object::Array *a = new object::Array;
+  if (x.real || y.real) {
+    real(&x);
+    real(&y);
+    a->packed = object::P_FLOAT;
+    a->floats.resize(x.n);
+    vec::add(x.floats, y.floats, a->floats.data(), x.n);
+  } else {
+    a->packed = object::P_INT;
+    a->ints.resize(x.n);
+    vec::add(x.ints, y.ints, a->ints.data(), x.n);
+  }
+  f->data.push(a);
+}
+
+// index of first element equal to number, -1 if not found
+void vecFind(Args &args, Frame *f) {
+  vecArgs(args, "vecFind", 2);
+  Numbers x;
+  unbox("vecFind", args.at(0), &x);
+  object::Object *v = number("vecFind", args.at(1));
+
+  if (x.real || v->kind() == object::FLOAT) {
+    real(&x);
+    f->data.push(new object::Int(vec::find(x.floats, numberValue(v), x.n)));
+  } else
+    f->data.push(new object::Int(
+        vec::find(x.ints, static_cast<object::Int *>(v)->value, x.n)));
+}
+
+// number of elements equal to number
+void vecCount(Args &args, Frame *f) {
+  vecArgs(args, "vecCount", 2);
+  Numbers x;
+  unbox("vecCount", args.at(0), &x);
+  object::Object *v = number("vecCount", args.at(1));
+
+  if (x.real || v->kind() == object::FLOAT) {
+    real(&x);
+    f->data.push(new object::Int(vec::count(x.floats, numberValue(v), x.n)));
+  } else
+    f->data.push(new object::Int(
+        vec::count(x.ints, static_cast<object::Int *>(v)->value, x.n)));
+}
+
+constexpr int l = 14; // length of builtin names
 static builtin bu[l] = {
     {"puts", puts},           // print to screen
     {"put", put},             // print to screen but no new line
     {"putl", putl},           // print to screen and end new line
     {"len", len},             // return the length of object
-    {"sleep", bsleep},        // sleep time
     {"type", type},           // type checker
     {"randomStr", randomStr}, // random string generator
+    {"vecSum", vecSum},       // sum of array
+    {"vecMin", vecMin},       // minimum of array
+    {"vecMax", vecMax},       // maximum of array
+    {"vecDot", vecDot},       // sum of products of two arrays
+    {"vecScale", vecScale},   // each element multiplied by number
+    {"vecAdd", vecAdd},       // sums of elements of two arrays
+    {"vecFind", vecFind},     // index of first element equal to number
+    {"vecCount", vecCount},   // number of elements equal to number
 };
 
 // return it is builtin function name
@@ -213,10 +404,10 @@ bool isBuiltinName(std::string name) {
 }
 
 // if its builtin function to call it
-void builtinFuncCall(std::string name, object::Object *obj, Frame *f) {
+void builtinFuncCall(std::string name, Args &args, Frame *f) {
   for (int i = 0; i < l; i++)
     if (bu[i].name == name)
-      bu[i].to(obj, f); // CALL
+      bu[i].to(args, f); // CALL
 }
 
 // regist the name of builtin
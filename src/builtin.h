@@ -22,17 +22,21 @@
 #include "frame.h"
 #include "state.h"
 #include "util.h"
+#include "vector.h"
+
+// arguments of builtin call, owned by the caller
+using Args = std::vector<object::Object *>;
 
 struct builtin {
-  std::string name;                      // builtin name
-  void (*to)(object::Object *, Frame *); // to handler function
+  std::string name;           // builtin name
+  void (*to)(Args &, Frame *); // to handler function
 };
 
 // return it is builtin function name
 bool isBuiltinName(std::string);
 
 // if its builtin function to call it
-void builtinFuncCall(std::string, object::Object *, Frame *);
+void builtinFuncCall(std::string, Args &, Frame *);
 
 // regist the name of builtin
 void regBuiltinName(Frame *);
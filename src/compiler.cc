@@ -31,13 +31,10 @@ void Compiler::compile() {
 }
 
 // push bytecode to entity
-void Compiler::emitCode(byte::Code co) {
-  this->now->codes.push_back(co);
-  this->now->lineno.push_back(this->line);
-}
+void Compiler::emitCode(byte::Code co) { this->now->emitCode(co, this->line); }
 
 // push offset to entity
-void Compiler::emitOffset(int off) { this->now->offsets.push_back(off); }
+void Compiler::emitOffset(int off) { this->now->emitOperand(off); }
 
 // push constant to entity
 void Compiler::emitConstant(object::Object *obj) {
@@ -45,18 +42,49 @@ void Compiler::emitConstant(object::Object *obj) {
   this->emitOffset(this->icf++);
 }
 
+// push deduplicated literal to entity
+void Compiler::emitLiteral(token::Token tok) {
+  std::string key = std::to_string(tok.kind) + tok.literal; // kind and literal
+
+  auto iter = pool->constants.find(key);
+  if (iter != pool->constants.end()) {
+    // found
+    this->emitOffset(iter->second); // only push offset
+    return;
+  }
+
+  object::Object *obj = nullptr;
+
+  if (tok.kind == token::NUM) {
+    obj = new object::Int(std::stoi(tok.literal));
+  }
+  if (tok.kind == token::FLOAT) {
+    obj = new object::Float(std::stof(tok.literal));
+  }
+  if (tok.kind == token::STR) {
+    obj =
+        // judge long characters at here
+        new object::Str(tok.literal, tok.literal.back() == '`');
+  }
+  if (tok.kind == token::CHAR) {
+    obj = new object::Char(tok.literal.at(0));
+  }
+
+  pool->constants.insert(std::make_pair(key, this->icf)); // new constant
+  this->emitConstant(obj);
+}
+
 // push name to entity
 void Compiler::emitName(std::string v) {
-  std::vector<std::string>::iterator iter =
-      std::find(now->names.begin(), now->names.end(), v);
-  if (iter != now->names.end()) {
+  auto iter = pool->names.find(v);
+  if (iter != pool->names.end()) {
     // found
-    this->emitOffset(
-        std::distance(now->names.begin(), iter)); // only push offset
+    this->emitOffset(iter->second); // only push offset
   } else {
     // not found
-    this->now->names.push_back(v); // push new name
-    this->emitOffset(this->inf++); // push new offset
+    this->now->names.push_back(v);                   // push new name
+    pool->names.insert(std::make_pair(v, this->inf)); // index it
+    this->emitOffset(this->inf++);                    // push new offset
   }
 }
 
@@ -70,33 +98,281 @@ void Compiler::emitJumpOffset(int off) {
   this->now->jumpOffsets.push_back(off);
 }
 
-// insert position with current counts of bytecode
-void Compiler::insertPosOffset(int pos) {
-  this->now->offsets.insert(now->offsets.begin() + pos, now->codes.size());
-  this->emitJumpOffset(now->codes.size());
-}
+// push a placeholder for jump and return its position in codes
+int Compiler::emitHolder(int val) { return this->now->emitJump(val); }
+
+// backpatch the placeholder with current position of bytecode
+void Compiler::patchHolder(int pos) { this->patchHolder(pos, now->codes.size()); }
 
 // with custom value
-void Compiler::insertPosOffset(int pos, int val) {
-  this->now->offsets.insert(now->offsets.begin() + pos, val);
+void Compiler::patchHolder(int pos, int val) {
+  this->now->patchJump(pos, val);
   this->emitJumpOffset(val);
 }
 
-// replace placeHolder
+// replace placeHolder of the innermost loop
 void Compiler::replaceHolder(int original) {
-  for (std::vector<int>::iterator iter = now->offsets.begin();
-       iter != now->offsets.end(); iter++) {
-    // out statement
-    if (*iter == -1) {
-      *iter = now->codes.size();
-      this->emitJumpOffset(now->codes.size());
+  Loop l = this->loops.back();
+  this->loops.pop_back();
+
+  // out statement
+  for (auto i : l.outs)
+    this->patchHolder(i);
+  // go statement
+  for (auto i : l.gos)
+    this->patchHolder(i, original);
+}
+
+// largest size of function body to be inlined
+constexpr int inlineBudget = 32;
+
+// size of expression without side effect, -1 if it can't be inlined
+int Compiler::exprCost(ast::Expr *expr, std::string self) {
+  int cost = 1;
+
+  switch (expr->kind()) {
+  case ast::EXPR_LITERAL:
+  case ast::EXPR_NAME:
+    return cost;
+  case ast::EXPR_BINARY: {
+    ast::BinaryExpr *b = static_cast<ast::BinaryExpr *>(expr);
+
+    if (b->op.kind == token::AS_ADD || b->op.kind == token::AS_SUB ||
+        b->op.kind == token::AS_MUL || b->op.kind == token::AS_DIV ||
+        b->op.kind == token::AS_SUR)
+      return -1; // ASSIGN
+    int l = this->exprCost(b->left, self);
+    int r = this->exprCost(b->right, self);
+
+    return l < 0 || r < 0 ? -1 : cost + l + r;
+  }
+  case ast::EXPR_GROUP:
+    return this->exprCost(static_cast<ast::GroupExpr *>(expr)->expr, self);
+  case ast::EXPR_UNARY: {
+    int e = this->exprCost(static_cast<ast::UnaryExpr *>(expr)->expr, self);
+    return e < 0 ? -1 : cost + e;
+  }
+  case ast::EXPR_GET: {
+    int e = this->exprCost(static_cast<ast::GetExpr *>(expr)->expr, self);
+    return e < 0 ? -1 : cost + e;
+  }
+  case ast::EXPR_INDEX: {
+    ast::IndexExpr *i = static_cast<ast::IndexExpr *>(expr);
+
+    int l = this->exprCost(i->left, self);
+    int r = this->exprCost(i->right, self);
+
+    return l < 0 || r < 0 ? -1 : cost + l + r;
+  }
+  case ast::EXPR_SLICE: {
+    ast::SliceExpr *s = static_cast<ast::SliceExpr *>(expr);
+
+    for (auto i : {s->left, s->lo, s->hi}) {
+      int e = i == nullptr ? 0 : this->exprCost(i, self);
+      if (e < 0)
+        return -1;
+      cost += e;
+    }
+    return cost;
+  }
+  case ast::EXPR_CALL: {
+    ast::CallExpr *c = static_cast<ast::CallExpr *>(expr);
+
+    if (c->callee->kind() != ast::EXPR_NAME ||
+        static_cast<ast::NameExpr *>(c->callee)->token.literal == self)
+      return -1; // RECURSIVE
+    for (auto i : c->arguments) {
+      int e = this->exprCost(i, self);
+      if (e < 0)
+        return -1;
+      cost += e;
     }
-    // tin statement
-    if (*iter == -2) {
-      *iter = original;
-      this->emitJumpOffset(original);
+    return cost;
+  }
+  case ast::EXPR_ARRAY:
+  case ast::EXPR_TUPLE: {
+    std::vector<ast::Expr *> elem =
+        expr->kind() == ast::EXPR_ARRAY
+            ? static_cast<ast::ArrayExpr *>(expr)->elements
+            : static_cast<ast::TupleExpr *>(expr)->elements;
+
+    for (auto i : elem) {
+      int e = this->exprCost(i, self);
+      if (e < 0)
+        return -1;
+      cost += e;
     }
+    return cost;
   }
+  default:
+    return -1; // SET, ASSIGN, MAP and NEW
+  }
+}
+
+// return expression of block with a single ret statement
+ast::Expr *Compiler::retExpr(ast::BlockStmt *block) {
+  if (block == nullptr || block->block.size() != 1 ||
+      block->block.front()->kind() != ast::STMT_RET)
+    return nullptr;
+
+  ast::RetStmt *r = static_cast<ast::RetStmt *>(block->block.front());
+
+  if (r->stmt == nullptr || r->stmt->kind() != ast::STMT_EXPR)
+    return nullptr;
+  return static_cast<ast::ExprStmt *>(r->stmt)->expr;
+}
+
+// is function small and simple enough to inline
+//
+// ret <expr>
+//
+// if <cond> ret <expr> ef <cond> ret <expr> nf ret <expr> end
+//
+// if <cond> ret <expr> end ret <expr>
+bool Compiler::inlinable(ast::FuncStmt *f) {
+  if (f->ret == nullptr)
+    return false;
+
+  std::vector<ast::Stmt *> body = f->block->block;
+  std::string self = f->name.literal;
+
+  // ret <expr>
+  if (body.size() == 1 && body.front()->kind() == ast::STMT_RET) {
+    ast::Expr *e = this->retExpr(f->block);
+    if (e == nullptr)
+      return false;
+    int cost = this->exprCost(e, self);
+    return cost > 0 && cost <= inlineBudget;
+  }
+
+  if (body.empty() || body.size() > 2 || body.front()->kind() != ast::STMT_IF)
+    return false;
+  ast::IfStmt *i = static_cast<ast::IfStmt *>(body.front());
+
+  std::vector<ast::Expr *> exprs = {i->condition, this->retExpr(i->ifBranch)};
+
+  for (auto e : i->efBranch) {
+    exprs.push_back(e.first);
+    exprs.push_back(this->retExpr(e.second));
+  }
+  // nf branch or the last ret statement
+  if (body.size() == 1 && i->nfBranch != nullptr)
+    exprs.push_back(this->retExpr(i->nfBranch));
+  else if (body.size() == 2 && i->nfBranch == nullptr) {
+    ast::BlockStmt last({body.back()});
+    exprs.push_back(this->retExpr(&last));
+  } else
+    return false;
+
+  int cost = 0;
+  for (auto e : exprs) {
+    if (e == nullptr)
+      return false;
+    int c = this->exprCost(e, self);
+    if (c < 0)
+      return false;
+    cost += c;
+  }
+  return cost <= inlineBudget;
+}
+
+// substitute the body of function at call site
+bool Compiler::inlineCall(ast::CallExpr *c) {
+  if (c->callee->kind() != ast::EXPR_NAME)
+    return false;
+  std::string name = static_cast<ast::NameExpr *>(c->callee)->token.literal;
+
+  if (this->whole || c == this->tail || this->inlines.count(name) == 0 ||
+      this->renames.count(name) != 0 ||
+      std::find(locals.begin(), locals.end(), name) != locals.end() ||
+      std::find(inlining.begin(), inlining.end(), name) != inlining.end())
+    return false;
+  ast::FuncStmt *f = this->inlines.at(name);
+
+  if (f->arguments.size() != c->arguments.size())
+    return false; // ERROR AT RUNTIME
+
+  now->inlined.push_back(std::make_pair(now->codes.size(), name));
+
+  // parameters in order of source
+  std::vector<std::pair<std::string, Type *>> params;
+  for (auto &i : f->arguments)
+    params.push_back(std::make_pair(i.first->literal, i.second));
+
+  std::map<std::string, std::string> outer = this->renames;
+  std::vector<std::string> temps(params.size());
+
+  // arguments from right to left as call, to temporary names
+  for (int i = c->arguments.size(); i > 0; i--) {
+    this->expr(c->arguments.at(i - 1));
+
+    temps.at(i - 1) = params.at(i - 1).first + "#" +
+                      std::to_string(this->inlineCount++); // NAME#N
+
+    this->emitCode(byte::STORE);
+    this->emitName(temps.at(i - 1));
+    this->emitType(params.at(i - 1).second); // TYPE CHECKER
+  }
+  for (int i = 0; i < params.size(); i++)
+    this->renames[params.at(i).first] = temps.at(i);
+
+  this->inlining.push_back(name);
+
+  std::vector<ast::Stmt *> body = f->block->block;
+
+  if (body.front()->kind() == ast::STMT_RET) {
+    this->expr(this->retExpr(f->block));
+  } else {
+    ast::IfStmt *i = static_cast<ast::IfStmt *>(body.front());
+    std::vector<int> ends; // jump out after each branch
+
+    this->expr(i->condition);
+    this->emitCode(byte::F_JUMP);
+    int next = this->emitHolder();
+
+    this->expr(this->retExpr(i->ifBranch));
+    this->emitCode(byte::JUMP);
+    ends.push_back(this->emitHolder());
+
+    for (auto e : i->efBranch) {
+      this->patchHolder(next); // TO: ef (F_JUMP)
+
+      this->expr(e.first);
+      this->emitCode(byte::F_JUMP);
+      next = this->emitHolder();
+
+      this->expr(this->retExpr(e.second));
+      this->emitCode(byte::JUMP);
+      ends.push_back(this->emitHolder());
+    }
+    this->patchHolder(next); // TO: nf (F_JUMP)
+
+    if (i->nfBranch != nullptr) {
+      this->expr(this->retExpr(i->nfBranch));
+    } else {
+      ast::BlockStmt last({body.back()});
+      this->expr(this->retExpr(&last));
+    }
+    for (auto e : ends)
+      this->patchHolder(e);
+  }
+
+  this->inlining.pop_back();
+  this->renames = outer;
+
+  // RETURN VALUE TO A TEMPORARY OF ITS TYPE, CHECKED AS THE CALL DOES
+  temps.push_back("ret#" + std::to_string(this->inlineCount++));
+  this->emitCode(byte::STORE);
+  this->emitName(temps.back());
+  this->emitType(f->ret); // TYPE CHECKER
+  this->emitCode(byte::LOAD);
+  this->emitName(temps.back());
+
+  for (auto i : temps) {
+    this->emitCode(byte::DEL);
+    this->emitName(i);
+  }
+  return true;
 }
 
 // expression
@@ -104,23 +380,9 @@ void Compiler::expr(ast::Expr *expr) {
   switch (expr->kind()) {
   case ast::EXPR_LITERAL: {
     ast::LiteralExpr *l = static_cast<ast::LiteralExpr *>(expr);
-    token::Token tok = l->token;
 
-    if (tok.kind == token::NUM) {
-      this->emitConstant(new object::Int(std::stoi(tok.literal)));
-    }
-    if (tok.kind == token::FLOAT) {
-      this->emitConstant(new object::Float(std::stof(tok.literal)));
-    }
-    if (tok.kind == token::STR) {
-      this->emitConstant(
-          // judge long characters at here
-          new object::Str(tok.literal, tok.literal.back() == '`'));
-    }
-    if (tok.kind == token::CHAR) {
-      this->emitConstant(new object::Char(tok.literal.at(0)));
-    }
     this->emitCode(byte::CONST);
+    this->emitLiteral(l->token);
   } break;
   case ast::EXPR_BINARY: {
     ast::BinaryExpr *b = static_cast<ast::BinaryExpr *>(expr);
@@ -181,8 +443,8 @@ void Compiler::expr(ast::Expr *expr) {
         b->op.kind == token::AS_SUR) {
       ast::NameExpr *n = static_cast<ast::NameExpr *>(b->left);
 
-      this->emitName(n->token.literal);
       this->emitCode(byte::ASSIGN);
+      this->emitName(n->token.literal);
     }
   } break;
   //
@@ -209,12 +471,20 @@ void Compiler::expr(ast::Expr *expr) {
     ast::NameExpr *n = static_cast<ast::NameExpr *>(expr);
 
     this->emitCode(byte::LOAD);
-    this->emitName(n->token.literal); // new name
+
+    auto r = this->renames.find(n->token.literal);
+    if (r != this->renames.end())
+      this->emitName(r->second); // parameter of inlined function
+    else
+      this->emitName(n->token.literal); // new name
   } break;
   //
   case ast::EXPR_CALL: {
     ast::CallExpr *c = static_cast<ast::CallExpr *>(expr);
 
+    if (this->inlineCall(c))
+      break; // INLINED
+
     this->expr(c->callee);
 
     for (int i = c->arguments.size(); i > 0; i--)
@@ -249,12 +519,33 @@ void Compiler::expr(ast::Expr *expr) {
     this->expr(a->value);
 
     if (a->expr->kind() == ast::EXPR_NAME) {
+      std::string name = static_cast<ast::NameExpr *>(a->expr)->token.literal;
+
+      this->inlines.erase(name); // not constant function
+
       this->emitCode(byte::ASSIGN);
-      this->emitName(static_cast<ast::NameExpr *>(a->expr)->token.literal);
+      this->emitName(name);
+    } else if (a->expr->kind() == ast::EXPR_INDEX &&
+               static_cast<ast::IndexExpr *>(a->expr)->left->kind() ==
+                   ast::EXPR_NAME) {
+      ast::IndexExpr *i = static_cast<ast::IndexExpr *>(a->expr);
+      std::string name = static_cast<ast::NameExpr *>(i->left)->token.literal;
+
+      this->expr(i->right); // index
+
+      this->emitCode(byte::REPLACE_L); // replace of name
+      auto r = this->renames.find(name);
+      this->emitName(r != this->renames.end() ? r->second : name);
+    } else if (a->expr->kind() == ast::EXPR_INDEX) {
+      ast::IndexExpr *i = static_cast<ast::IndexExpr *>(a->expr);
+
+      this->expr(i->right);  // index
+      this->target(i->left); // nested object
+      this->emitCode(byte::REPLACE);
     } else {
       this->expr(a->expr); // index
       // index replace
-      if (now->codes.back() == byte::INDEX) {
+      if (now->codes.at(now->last) == byte::INDEX) {
         this->now->codes.pop_back();   // pop
         this->emitCode(byte::REPLACE); // push
       }
@@ -306,6 +597,20 @@ void Compiler::expr(ast::Expr *expr) {
     this->emitCode(byte::INDEX);
   } break;
   //
+  case ast::EXPR_SLICE: {
+    ast::SliceExpr *s = static_cast<ast::SliceExpr *>(expr);
+
+    if (s->hi != nullptr)
+      this->expr(s->hi);
+    if (s->lo != nullptr)
+      this->expr(s->lo);
+    this->expr(s->left);
+
+    this->emitCode(byte::SLICE);
+    // bounds given, 1 of lo and 2 of hi
+    this->emitOffset((s->lo != nullptr) | (s->hi != nullptr) << 1);
+  } break;
+  //
   case ast::EXPR_NEW: {
     ast::NewExpr *n = static_cast<ast::NewExpr *>(expr);
 
@@ -323,6 +628,35 @@ void Compiler::expr(ast::Expr *expr) {
   }
 }
 
+// object of left of index assignment
+void Compiler::target(ast::Expr *expr) {
+  if (expr->kind() == ast::EXPR_GET) {
+    ast::GetExpr *g = static_cast<ast::GetExpr *>(expr);
+
+    this->expr(g->expr); // whole
+    this->emitCode(byte::GET_W);
+    this->emitName(g->name.literal); // member
+    return;
+  }
+  if (expr->kind() != ast::EXPR_INDEX) {
+    this->expr(expr);
+    return;
+  }
+  ast::IndexExpr *i = static_cast<ast::IndexExpr *>(expr);
+
+  this->expr(i->right); // index
+  if (i->left->kind() == ast::EXPR_NAME) {
+    std::string name = static_cast<ast::NameExpr *>(i->left)->token.literal;
+
+    this->emitCode(byte::INDEX_L); // index of name
+    auto r = this->renames.find(name);
+    this->emitName(r != this->renames.end() ? r->second : name);
+  } else {
+    this->target(i->left);
+    this->emitCode(byte::INDEX_W);
+  }
+}
+
 // statements
 void Compiler::stmt(ast::Stmt *stmt) {
   switch (stmt->kind()) {
@@ -333,6 +667,9 @@ void Compiler::stmt(ast::Stmt *stmt) {
   case ast::STMT_VAR: {
     ast::VarStmt *v = static_cast<ast::VarStmt *>(stmt);
 
+    this->inlines.erase(v->name.literal); // not constant function
+    this->locals.push_back(v->name.literal);
+
     if (v->expr != nullptr)
       this->expr(v->expr); // initial value
     else
@@ -358,16 +695,18 @@ void Compiler::stmt(ast::Stmt *stmt) {
      */
     this->expr(i->condition);
     this->emitCode(byte::F_JUMP);
-    int ifPos = now->offsets.size();
+    int ifPos = this->emitHolder();
 
     this->stmt(i->ifBranch);
 
+    int ifOff = -1; // jump after execution if branch
+
     if (!i->efBranch.empty() ||
-        i->nfBranch != nullptr)   // ignore single expr to JUMP
+        i->nfBranch != nullptr) { // ignore single expr to JUMP
       this->emitCode(byte::JUMP); // jump out after
-
-    int ifOff = now->offsets.size(); // jump after execution if branch
-    std::vector<int> tempEfOffs;     // ef condition offsets
+      ifOff = this->emitHolder();
+    }
+    std::vector<int> tempEfOffs; // ef condition offsets
 
     // ef branch
     if (!i->efBranch.empty()) {
@@ -376,20 +715,20 @@ void Compiler::stmt(ast::Stmt *stmt) {
       for (auto i : i->efBranch) {
         // if jump to the first ef
         if (firstStmt) {
-          this->insertPosOffset(ifPos); // TO: if (F_JUMP)
+          this->patchHolder(ifPos); // TO: if (F_JUMP)
           firstStmt = false;
         }
 
         this->expr(i.first); // condition
         this->emitCode(byte::F_JUMP);
-        int efPos = now->offsets.size();
+        int efPos = this->emitHolder();
 
         this->stmt(i.second); // block
-        this->insertPosOffset(efPos,
-                              now->codes.size() + 1); // TO: ef (F_JUMP)
 
         this->emitCode(byte::JUMP); // jump out after
-        tempEfOffs.push_back(now->offsets.size());
+        tempEfOffs.push_back(this->emitHolder());
+
+        this->patchHolder(efPos); // TO: ef (F_JUMP)
       }
       // nf branch
       if (i->nfBranch != nullptr)
@@ -397,24 +736,18 @@ void Compiler::stmt(ast::Stmt *stmt) {
     }
     // nf branch
     else {
-      if (i->nfBranch != nullptr) {
-        this->insertPosOffset(ifPos); // TO: if (F_JUMP)
+      this->patchHolder(ifPos); // TO: if (F_JUMP)
+
+      if (i->nfBranch != nullptr)
         this->stmt(i->nfBranch);
-      } else {
-        // no ef and nf statement
-        this->insertPosOffset(ifPos); // TO: if (F_JUMP)
-      }
     }
 
     // for (auto i : tempEfOffs) std::cout << i << std::endl;
-    for (int i = 0; i < tempEfOffs.size(); i++) {
-      // insertion increment successively
-      this->insertPosOffset(tempEfOffs.at(i) + i);
-    }
+    for (auto i : tempEfOffs)
+      this->patchHolder(i); // TO: ef (JUMP)
 
-    if (!i->efBranch.empty() ||
-        i->nfBranch != nullptr)         // ignore single expr to JUMP
-      this->insertPosOffset(ifOff + 1); // TO: if (JUMP)
+    if (ifOff != -1)
+      this->patchHolder(ifOff); // TO: if (JUMP)
   } break;
   //
   case ast::STMT_FOR: {
@@ -423,27 +756,120 @@ void Compiler::stmt(ast::Stmt *stmt) {
     this->stmt(f->init); // initializer
 
     int original = now->codes.size(); // original state: for callback loops
+    this->loops.push_back(Loop());
 
     this->stmt(f->cond); // condition
     this->emitCode(byte::F_JUMP);
-    int ePos = now->offsets.size(); // skip loop for FALSE
+    int ePos = this->emitHolder(); // skip loop for FALSE
 
     this->stmt(f->block); // block
     this->stmt(f->more);  // update
 
-    this->insertPosOffset(ePos, now->codes.size() + 1); // TO: (F_JUMP)
-
     this->emitCode(byte::JUMP);     // back to original state
-    this->emitOffset(original);     // offset
+    this->emitHolder(original);     // offset
+    this->emitJumpOffset(original); // DEBUG
+
+    this->patchHolder(ePos); // TO: (F_JUMP)
+
+    this->replaceHolder(original); // REPLACE
+  } break;
+  //
+  case ast::STMT_FOR_IN: {
+    ast::ForInStmt *f = static_cast<ast::ForInStmt *>(stmt);
+    int slot = this->loops.size(); // iterator of loop depth
+
+    this->expr(f->expr);
+    this->emitCode(byte::ITER_INIT);
+    this->emitOffset(slot);
+
+    int original = now->codes.size(); // next element
+    this->loops.push_back(Loop());
+
+    this->emitCode(byte::ITER_NEXT);
+    this->emitOffset(slot);
+    this->emitName(f->names.front().literal); // index or key
+    this->emitName(f->names.back().literal);  // element, same if one name
+    int ePos = this->emitHolder(); // skip loop for END
+
+    this->stmt(f->block); // block
+
+    this->emitCode(byte::JUMP);     // back to next element
+    this->emitHolder(original);     // offset
     this->emitJumpOffset(original); // DEBUG
 
+    this->patchHolder(ePos); // TO: (ITER_NEXT)
+
     this->replaceHolder(original); // REPLACE
   } break;
   //
+  case ast::STMT_PAR: {
+    ast::ParStmt *p = static_cast<ast::ParStmt *>(stmt);
+
+    this->expr(p->expr); // count or array
+
+    int entitiesSize = this->entities.size() - 1; // original
+
+    this->entities.push_back(new Entity("par")); // body runs on threads
+    this->now = this->entities.back();
+
+    object::Func *obj = new object::Func;
+    obj->name = "par";
+    obj->ret = nullptr;
+
+    for (auto &i : p->reduce)
+      this->now->reduce.push_back(
+          std::make_pair(i.first.literal.front(), i.second.literal));
+
+    int x = this->icf;
+    int y = this->inf;
+    int z = this->itf;
+
+    Pool *pool = this->pool;
+    std::vector<Loop> l = this->loops;
+    std::vector<std::string> v = this->locals;
+
+    this->icf = this->inf = this->itf = 0;
+    this->pool = new Pool; // pools of new entity
+    this->loops.clear();
+
+    this->locals.clear();
+    for (auto &i : p->names)
+      this->locals.push_back(i.literal);
+    for (auto &i : p->reduce)
+      this->locals.push_back(i.second.literal);
+
+    this->stmt(p->block);
+
+    this->locals = v;
+
+    this->icf = x;
+    this->inf = y;
+    this->itf = z;
+
+    delete this->pool;
+    this->pool = pool;
+    this->loops = l;
+
+    obj->entity = this->now; // body entity
+
+    this->entities.pop_back();
+    this->now = this->entities.at(entitiesSize); // restore
+
+    this->emitCode(byte::PAR);
+    this->emitConstant(obj);
+    this->emitName(p->names.front().literal); // index
+    this->emitName(p->names.back().literal);  // element, same if one name
+
+    for (auto &i : p->reduce)
+      this->inlines.erase(i.second.literal); // not constant function
+  } break;
+  //
   case ast::STMT_AOP: {
     ast::AopStmt *a = static_cast<ast::AopStmt *>(stmt);
 
     int original = now->codes.size(); // original state
+    int ePos = -1;                    // skip loop for FALSE
+    this->loops.push_back(Loop());
 
     if (a->expr == nullptr)
       this->stmt(a->block); // skip condition
@@ -451,17 +877,18 @@ void Compiler::stmt(ast::Stmt *stmt) {
     else {
       this->expr(a->expr);
       this->emitCode(byte::F_JUMP);
-      int ePos = now->offsets.size(); // skip loop for FALSE
+      ePos = this->emitHolder(); // skip loop for FALSE
 
       this->stmt(a->block); // block
-                            // jump to next bytecode
-      this->insertPosOffset(ePos, now->codes.size() + 1); // TO: (F_JUMP)
     }
 
     this->emitCode(byte::JUMP);     // back to original state
-    this->emitOffset(original);     // offset
+    this->emitHolder(original);     // offset
     this->emitJumpOffset(original); // DEBUG
 
+    if (ePos != -1)
+      this->patchHolder(ePos); // TO: (F_JUMP), jump to next bytecode
+
     this->replaceHolder(original); // REPLACE
   } break;
   //
@@ -474,7 +901,10 @@ void Compiler::stmt(ast::Stmt *stmt) {
     // jump straight out
     this->emitCode(o->expr == nullptr ? byte::JUMP : byte::T_JUMP);
     // place holder
-    this->emitOffset(-1);
+    int pos = this->emitHolder();
+
+    if (!this->loops.empty())
+      this->loops.back().outs.push_back(pos);
   } break;
   //
   case ast::STMT_GO: {
@@ -486,7 +916,10 @@ void Compiler::stmt(ast::Stmt *stmt) {
     // jump straight out
     this->emitCode(t->expr == nullptr ? byte::JUMP : byte::T_JUMP);
     // place holder
-    this->emitOffset(-2);
+    int pos = this->emitHolder(-2);
+
+    if (!this->loops.empty())
+      this->loops.back().gos.push_back(pos);
   } break;
   //
   case ast::STMT_FUNC: {
@@ -508,16 +941,40 @@ void Compiler::stmt(ast::Stmt *stmt) {
     int y = this->inf;
     int z = this->itf;
 
+    Pool *p = this->pool;
+    std::vector<Loop> l = this->loops;
+
     this->icf = 0; // x
     this->inf = 0; // y
     this->itf = 0; // z
 
+    this->pool = new Pool; // pools of new entity
+    this->loops.clear();
+
+    std::vector<std::string> v = this->locals;
+    bool g = this->yields;
+
+    this->yields = false;
+
+    this->locals.clear();
+    for (auto &i : f->arguments)
+      this->locals.push_back(i.first->literal); // parameters
+
     this->stmt(f->block);
 
+    obj->gen = this->yields; // GENERATOR
+    this->yields = g;
+
+    this->locals = v;
+
     this->icf = x;
     this->inf = y;
     this->itf = z;
 
+    delete this->pool;
+    this->pool = p;
+    this->loops = l;
+
     obj->entity = this->now; // function entity
 
     this->entities.pop_back(); // lose
@@ -525,6 +982,15 @@ void Compiler::stmt(ast::Stmt *stmt) {
     // if more than one it points to the last one
     this->now = this->entities.at(entitiesSize); // restore to main entity
 
+    // functions of main entity to inline
+    if (entitiesSize == 0 && this->inlinable(f)) {
+      this->inlines[f->name.literal] = f;
+      if (!this->module.empty())
+        (*this->modInlines)[this->module][f->name.literal] = f;
+    } else {
+      this->inlines.erase(f->name.literal);
+    }
+
     // TO main ENTITY
     this->emitCode(byte::FUNC);
     this->emitConstant(obj); // push to constant object
@@ -555,10 +1021,19 @@ void Compiler::stmt(ast::Stmt *stmt) {
     int y = this->inf;
     int z = this->itf;
 
+    Pool *p = this->pool;
+    std::vector<Loop> l = this->loops;
+
     this->icf = 0; // x
     this->inf = 0; // y
     this->itf = 0; // z
 
+    this->pool = new Pool; // pools of new entity
+    this->loops.clear();
+
+    bool g = this->whole;
+    this->whole = true; // NO INLINING, A NAME MAY BE OF WHOLE
+
     // block statement
     for (auto i : w->body->block) {
       // interface definition
@@ -570,11 +1045,16 @@ void Compiler::stmt(ast::Stmt *stmt) {
       }
       this->stmt(i);
     }
+    this->whole = g;
 
     this->icf = x;
     this->inf = y;
     this->itf = z;
 
+    delete this->pool;
+    this->pool = p;
+    this->loops = l;
+
     obj->entity = this->now; // whole entity
 
     this->entities.pop_back(); // lose
@@ -590,6 +1070,8 @@ void Compiler::stmt(ast::Stmt *stmt) {
   case ast::STMT_MOD: {
     ast::ModStmt *m = static_cast<ast::ModStmt *>(stmt);
 
+    this->module = m->name.literal;
+
     this->emitCode(byte::MOD);
     this->emitName(m->name.literal);
   } break;
@@ -597,6 +1079,10 @@ void Compiler::stmt(ast::Stmt *stmt) {
   case ast::STMT_USE: {
     ast::UseStmt *u = static_cast<ast::UseStmt *>(stmt);
 
+    if (this->modInlines->count(u->name.literal) != 0)
+      for (auto &i : this->modInlines->at(u->name.literal))
+        this->inlines[i.first] = i.second; // functions of module
+
     this->emitCode(byte::USE);
     this->emitName(u->name.literal);
   } break;
@@ -604,12 +1090,31 @@ void Compiler::stmt(ast::Stmt *stmt) {
   case ast::STMT_RET: {
     ast::RetStmt *r = static_cast<ast::RetStmt *>(stmt);
 
+    if (r->stmt != nullptr && r->stmt->kind() == ast::STMT_EXPR &&
+        now->title != "main")
+      this->tail = static_cast<ast::ExprStmt *>(r->stmt)->expr;
     if (r->stmt != nullptr)
       this->stmt(r->stmt);
+    this->tail = nullptr;
+
+    // call in tail position of function
+    if (r->stmt != nullptr && r->stmt->kind() == ast::STMT_EXPR &&
+        static_cast<ast::ExprStmt *>(r->stmt)->expr->kind() ==
+            ast::EXPR_CALL &&
+        now->codes.at(now->last) == byte::CALL && now->title != "main") {
+      now->codes.at(now->last) = byte::TAIL_CALL; // RET if frame not reused
+    }
 
     this->emitCode(r->stmt == nullptr ? byte::RET_N : byte::RET);
   } break;
   //
+  case ast::STMT_YIELD: {
+    this->expr(static_cast<ast::YieldStmt *>(stmt)->expr);
+    this->emitCode(byte::YIELD);
+
+    this->yields = true;
+  } break;
+  //
   case ast::STMT_ENUM: {
     ast::EnumStmt *e = static_cast<ast::EnumStmt *>(stmt);
 
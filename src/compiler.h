@@ -16,6 +16,8 @@
 #define DRIFT_COMPILER_H
 
 #include <algorithm>
+#include <map>
+#include <unordered_map>
 
 #include "ast.h"
 #include "entity.h"
@@ -23,6 +25,9 @@
 #include "opcode.h"
 #include "type.h"
 
+// small functions of compiled modules, by module name
+using Inlines = std::map<std::string, std::map<std::string, ast::FuncStmt *>>;
+
 // compiler structure
 class Compiler {
 private:
@@ -40,26 +45,76 @@ private:
   // offset of constant, offset of name, offset of type
   int icf = 0, inf = 0, itf = 0;
 
+  // hashed pools of the current entity
+  struct Pool {
+    std::unordered_map<std::string, int> names;     // name to offset
+    std::unordered_map<std::string, int> constants; // literal to offset
+  };
+  Pool *pool = new Pool;
+
+  // backpatch lists of the loop being compiled
+  struct Loop {
+    std::vector<int> outs; // out statements, jump to the end
+    std::vector<int> gos;  // go statements, jump to the original state
+  };
+  std::vector<Loop> loops;
+
   void emitCode(byte::Code);           // push bytecode to entity
   void emitOffset(int);                // push offset to entity
   void emitConstant(object::Object *); // push constant to entity
+  void emitLiteral(token::Token);      // push deduplicated literal to entity
   void emitName(std::string);          // push name to entity
   void emitType(Type *);               // push names type to entity
 
   void emitJumpOffset(int);
 
-  // insert position with current counts of bytecode
-  void insertPosOffset(int);
-  void insertPosOffset(int, int); // with custom value
+  // push a placeholder for jump and return its position in codes
+  int emitHolder(int = -1);
+  // backpatch the placeholder with current position of bytecode
+  void patchHolder(int);
+  void patchHolder(int, int); // with custom value
+
+  // small functions to be inlined at call sites, by function name
+  std::map<std::string, ast::FuncStmt *> inlines;
+  // names of inlined parameters to its temporary names
+  std::map<std::string, std::string> renames;
+
+  std::vector<std::string> inlining; // functions being inlined
+  std::vector<std::string> locals;   // names defined in current function
+
+  // compiling body of whole, its names are looked up in its table first
+  bool whole = false;
+
+  // call operand of ret in function, kept as a call to be a tail call
+  ast::Expr *tail = nullptr;
+
+  bool yields = false; // current function has yield
+
+  std::string module; // module name of compiling
+  int inlineCount = 0; // suffix of temporary names
+
+  Inlines *modInlines; // to functions of modules of runtime
+
+  // size of expression without side effect, -1 if it can't be inlined
+  int exprCost(ast::Expr *, std::string);
+  // return expression of block with a single ret statement
+  ast::Expr *retExpr(ast::BlockStmt *);
+  // is function small and simple enough to inline
+  bool inlinable(ast::FuncStmt *);
+  // substitute the body of function at call site
+  bool inlineCall(ast::CallExpr *);
 
   void expr(ast::Expr *); // expression
+  // object of left of index assignment, shared ones on its path are copied
+  void target(ast::Expr *);
   void stmt(ast::Stmt *); // statements
 
   void replaceHolder(int original); // replace placeHolder
 
 public:
-  Compiler(std::vector<ast::Stmt *> statements, std::vector<int> lineno)
-      : statements(statements), lineno(lineno) {
+  Compiler(std::vector<ast::Stmt *> statements, std::vector<int> lineno,
+           Inlines *modInlines)
+      : statements(statements), lineno(lineno), modInlines(modInlines) {
     this->line = lineno.front();
   }
 
@@ -12,73 +12,28 @@
 //          https://www.drift-lang.fun/
 //
 
+#include <atomic>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <thread>
 
-#include "compiler.h"
-#include "lexer.h"
-#include "parser.h"
-#include "semantic.h"
+#include "runtime.h"
+#include "slab.h"
 #include "version.h"
-#include "vm.h"
 
-#include "state.h"
 #include "system.h"
 
-// DEBUG to output tokens and statements
-bool DEBUG = false;
-// repl mode
-bool REPL = false;
-// dis mode
-bool DIS = false;
+// output statistics of allocator
+bool MEMSTAT = false;
 
-static State state;                        // global state
-static std::vector<object::Module *> mods; // global modules
-
-vm *mac; // local
+static Runtime rt;       // runtime of process
+static Context ctx(&rt); // program of command line
 
 // run source code
-void run(std::string source) {
+void run(Context &c, std::string source) {
   try {
-    // lexer
-    auto lex = new Lexer(source, &state);
-
-    lex->tokenizer();
-    if (DEBUG)
-      lex->dissembleTokens();
-
-    // parser
-    auto parser = new Parser(lex->tokens, &state);
-
-    parser->parse();
-    if (DEBUG)
-      parser->dissembleStmts();
-
-    // semantic
-    auto semantic = new Analysis(&parser->statements, &state);
-    // compiler
-    auto compiler = new Compiler(parser->statements, parser->lineno);
-    compiler->compile();
-
-    if (DIS)
-      for (auto i : compiler->entities)
-        i->dissemble();
-
-    // vm
-    if (REPL && mac != nullptr) {
-      // save the current symbol table
-      mac->top()->entity = compiler->entities[0];
-      mac->clean();
-    } else {
-      // new virtual machine
-      mac = new vm(compiler->entities[0], &mods, REPL, DIS, &state);
-    }
-    mac->evaluate();
-
-    // if (DIS)
-    // mac->main()->tb.dissemble();
-    //
+    c.run(c.compile(source));
   } catch (exp::Exp &e) {
     std::cout << e.stringer() << std::endl;
     return;
@@ -86,19 +41,19 @@ void run(std::string source) {
 }
 
 // FILE mode
-void runFile(const char *path) {
+void runFile(Context &c, const char *path) {
   std::string s;
   if (!fileString(path, &s))
     return;
 
-  state.filePath = std::string(path); // current read file
+  c.state.filePath = std::string(path); // current read file
 
-  run(s);
+  run(c, s);
 }
 
 // REPL mode
 void repl() {
-  REPL = true;
+  ctx.options.repl = true;
 
   char *line = (char *)malloc(1024);
   std::cout << VERS << std::endl;
@@ -112,45 +67,74 @@ void repl() {
     if (strlen(line) == 0) {
       continue;
     }
-    run(line);
+    run(ctx, line);
   }
 }
 
 // load standard modules
 bool loadStdModules() {
-  std::vector<std::string> *fs =
-      getAllFileWithPath(std::filesystem::current_path().string() + "/std");
+  try {
+    rt.load(std::filesystem::current_path().string() + "/std");
+  } catch (exp::Exp &e) {
+    // std::cout << "\033[31m" << e.stringer() << "\033[0m" << std::endl;
+    std::cout << e.stringer() << std::endl;
+    return false;
+  }
+  return true; // OK
+}
 
-  for (auto i : *fs) {
+// run files on threads, each one in a runtime of its own, standard modules
+// and files are compiled once and their code is shared by all threads
+int workers(std::vector<const char *> files, int n) {
+  Image image;
+  image.options = ctx.options;
+  try {
+    image.load(std::filesystem::current_path().string() + "/std");
+  } catch (exp::Exp &e) {
+    std::cout << e.stringer() << std::endl;
+    return 1;
+  }
+
+  std::vector<Entity *> mains(files.size(), nullptr);
+  for (int i = 0; i < files.size(); i++) {
     std::string s;
-    if (!fileString(i.c_str(), &s))
-      return false;
+    if (!fileString(files[i], &s))
+      continue;
 
+    State state;
+    state.filePath = std::string(files[i]);
     try {
-      // lexer
-      auto lex = new Lexer(s, &state);
-      lex->tokenizer();
-
-      // parser
-      auto parser = new Parser(lex->tokens, &state);
-      parser->parse();
-
-      // semantic
-      auto semantic = new Analysis(&parser->statements, &state);
-      // compiler
-      auto compiler = new Compiler(parser->statements, parser->lineno);
-      compiler->compile();
-
-      // vm
-      (new vm(compiler->entities[0], &mods, REPL, DIS, &state))->evaluate();
-      //
+      mains[i] = image.compile(s, &state);
     } catch (exp::Exp &e) {
-      // std::cout << "\033[31m" << e.stringer() << "\033[0m" << std::endl;
       std::cout << e.stringer() << std::endl;
-      return false;
     }
   }
-  return true; // OK
+
+  std::atomic<int> next = 0; // next file to run
+  std::vector<std::thread> threads;
+
+  for (int k = 0; k < n; k++)
+    threads.emplace_back([&] {
+      for (int i; (i = next++) < files.size();) {
+        if (mains[i] == nullptr)
+          continue;
+
+        Runtime w; // OF FILE, FREED AS IT ENDS
+        w.heap.pause = rt.heap.pause;
+
+        Context c(&w);
+        c.state.filePath = std::string(files[i]);
+        try {
+          w.load(image);
+          c.run(mains[i]);
+        } catch (exp::Exp &e) {
+          std::cout << e.stringer() << std::endl;
+        }
+      }
+    });
+  for (auto &i : threads)
+    i.join();
+  return 0;
 }
 
 // VER
@@ -163,34 +147,74 @@ int main(int argc, char **argv) {
     return 0;
   }
 
+  int threads = 0;                          // workers, 0 to run in process
+  std::vector<const char *> files{argv[1]}; // files of workers
+
+  if (argc >= 3) {
+    for (int i = 2; i < argc; i++) {
+      if (strcmp("-d", argv[i]) == 0) {
+        ctx.options.debug = true;
+      }
+      if (strcmp("-b", argv[i]) == 0) {
+        ctx.options.dis = true;
+      }
+      if (strcmp("-r", argv[i]) == 0) {
+        ctx.options.reg = true;
+      }
+      if (strcmp("-O", argv[i]) == 0) {
+        ctx.options.opt = true;
+      }
+      if (strcmp("-ir", argv[i]) == 0) {
+        ctx.options.opt = ctx.options.irdump = true;
+      }
+      if (strcmp("-m", argv[i]) == 0) {
+        MEMSTAT = true;
+      }
+      if (strcmp("-p", argv[i]) == 0 && i + 1 < argc) {
+        rt.heap.pause = atoi(argv[++i]); // MICROSECONDS OF SLICE
+      }
+      if (strcmp("--threads", argv[i]) == 0 && i + 1 < argc) {
+        threads = atoi(argv[++i]); // WORKERS
+      } else if (std::string(argv[i]).ends_with(".ft")) {
+        files.push_back(argv[i]); // MORE FILES
+      }
+    }
+    if (threads > 0)
+      return workers(files, threads);
+  }
+
   if (!loadStdModules())
     return 1; // load standard modules
 
   if (argc == 2) {
     // D
     if (strcmp(argv[1], "-d") == 0) {
-      DEBUG = true;
+      ctx.options.debug = true;
       repl();
     }
     // B
     else if (strcmp(argv[1], "-b") == 0) {
-      DIS = true;
+      ctx.options.dis = true;
       repl();
     }
     // O
     else {
-      runFile(argv[1]);
+      runFile(ctx, argv[1]);
     }
-  } else if (argc == 3) {
-    if (strcmp("-d", argv[2]) == 0) {
-      DEBUG = true;
+  } else if (argc >= 3) {
+    runFile(ctx, argv[1]);
+    for (int i = 1; i < files.size(); i++) {
+      Context c(&rt, ctx.options); // MORE FILES IN ORDER, EACH A PROGRAM
+      runFile(c, files[i]);
     }
-    if (strcmp("-b", argv[2]) == 0) {
-      DIS = true;
+
+    if (MEMSTAT) {
+      Runtime::Scope scope(&rt);
+      slab::dissemble();
+      gc::dissemble();
     }
-    runFile(argv[1]);
   } else {
     repl();
   }
   return 0;
-}
\ No newline at end of file
+}
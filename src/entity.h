@@ -15,6 +15,8 @@
 #ifndef DRIFT_ENTITY_H
 #define DRIFT_ENTITY_H
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -24,161 +26,262 @@
 #include "type.h"
 
 // entity structure
+//
+// bytecodes are packed into one stream, each opcode takes a byte and is
+// followed by its operands, every operand is an unsigned LEB128 varint
+//
+// jump operands are always padded to 4 bytes so that they can be backpatched
+//
 struct Entity {
   std::string title = ""; // TITLE FOR ENTITY
 
   explicit Entity() {}
   explicit Entity(std::string title) : title(title) {} // TO title
 
-  std::vector<byte::Code> codes;           // bytecodes
-  std::vector<int> offsets;                // offset of bytecode
+  std::vector<uint8_t> codes;              // bytecodes and operands
   std::vector<object::Object *> constants; // constant
   std::vector<std::string> names;          // names
   std::vector<Type *> types;               // type of variables
 
-  std::vector<int> lineno; // line no of each bytecode
+  // run-length line table, start of bytecodes and its line no
+  std::vector<std::pair<int, int>> lineno;
 
   std::vector<int> jumpOffsets;
 
+  int last = -1; // position of last opcode
+
+  // position and name of inlined functions
+  std::vector<std::pair<int, std::string>> inlined;
+
+  // operator and name of reductions, of the body of parallel loop
+  std::vector<std::pair<char, std::string>> reduce;
+
+  // push opcode to stream
+  void emitCode(byte::Code co, int line) {
+    if (lineno.empty() || lineno.back().second != line)
+      lineno.push_back(std::make_pair(codes.size(), line)); // new run
+
+    this->last = codes.size();
+    codes.push_back(co);
+  }
+
+  // push varint operand to stream
+  void emitOperand(int v) {
+    unsigned int u = v;
+    while (u >= 0x80) {
+      codes.push_back(u | 0x80);
+      u >>= 7;
+    }
+    codes.push_back(u);
+  }
+
+  // push padded jump operand and return its position
+  int emitJump(int to) {
+    int pos = codes.size();
+    codes.resize(pos + 4);
+
+    this->patchJump(pos, to);
+    return pos;
+  }
+
+  // backpatch jump operand at position
+  void patchJump(int pos, int to) {
+    unsigned int u = to & 0x0fffffff; // 28 bits
+
+    codes[pos + 0] = (u & 0x7f) | 0x80;
+    codes[pos + 1] = ((u >> 7) & 0x7f) | 0x80;
+    codes[pos + 2] = ((u >> 14) & 0x7f) | 0x80;
+    codes[pos + 3] = (u >> 21) & 0x7f;
+  }
+
+  // read operand and move position to next
+  inline int operand(int &ip) {
+    unsigned int v = 0;
+    int s = 0;
+    uint8_t b;
+    do {
+      b = codes[ip++];
+      v |= (unsigned int)(b & 0x7f) << s;
+      s += 7;
+    } while (b & 0x80);
+    return v;
+  }
+
+  // line no of bytecode at position
+  int line(int ip) {
+    auto iter = std::upper_bound(
+        lineno.begin(), lineno.end(), ip,
+        [](int ip, const std::pair<int, int> &r) { return ip < r.first; });
+    if (iter == lineno.begin())
+      return -1;
+    return (--iter)->second;
+  }
+
+  // operand of three address bytecode
+  std::string value(int v) {
+    if (v & 1)
+      return constants.at(v >> 1)->rawStringer();
+    return "'" + names.at(v >> 1) + "'";
+  }
+
   // output entity data
   void dissemble() {
     std::cout << "ENTITY '" << title << "': " << std::endl;
 
-    for (int ip = 0, op = 0; ip < codes.size(); ip++) {
-      byte::Code co = codes.at(ip);
+    for (int ip = 0; ip < codes.size();) {
+      int pc = ip;
+      byte::Code co = (byte::Code)codes.at(ip++);
+
+      for (auto &i : inlined)
+        if (i.first == pc)
+          printf("%20s %16s '%s'\n", "", "INLINE", i.second.c_str());
 
-      printf("%10s", std::find(jumpOffsets.begin(), jumpOffsets.end(), ip) ==
+      printf("%10s", std::find(jumpOffsets.begin(), jumpOffsets.end(), pc) ==
                              jumpOffsets.end()
                          ? ""
                          : ">>");
 
       switch (co) {
       case byte::CONST: {
-        printf("%10d %5d: %s %10d %s\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++),
-               constants.at(offsets.at(op))->rawStringer().c_str());
+        int off = operand(ip);
+        printf("%10d %5d: %s %10d %s\n", pc, line(pc),
+               byte::codeString[co].c_str(), off,
+               constants.at(off)->rawStringer().c_str());
       } break;
       case byte::ASSIGN: {
-        printf("%10d %5d: %s %9d '%s'\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++),
-               names.at(offsets.at(op)).c_str());
+        int off = operand(ip);
+        printf("%10d %5d: %s %9d '%s'\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str());
       } break;
       case byte::STORE: {
-        printf("%10d %5d: %s %10d '%s' %d %s\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op),
-               names.at(offsets.at(op)).c_str(), offsets.at(op + 1),
-               types.at(offsets.at(op + 1))->stringer().c_str());
-        op += 2;
+        int off = operand(ip);
+        int t = operand(ip);
+        printf("%10d %5d: %s %10d '%s' %d %s\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str(), t,
+               types.at(t)->stringer().c_str());
       } break;
       case byte::LOAD:
       case byte::NAME: {
-        printf("%10d %5d: %s %11d '%s'\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++),
-               names.at(offsets.at(op)).c_str());
+        int off = operand(ip);
+        printf("%10d %5d: %s %11d '%s'\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str());
       } break;
       case byte::FUNC:
       case byte::ENUM: {
-        printf("%10d %5d: %s %11d %s\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++),
-               constants.at(offsets.at(op))->rawStringer().c_str());
+        int off = operand(ip);
+        printf("%10d %5d: %s %11d %s\n", pc, line(pc),
+               byte::codeString[co].c_str(), off,
+               constants.at(off)->rawStringer().c_str());
       } break;
       case byte::WHOLE: {
-        printf("%10d %5d: %s %10d %s\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++),
-               constants.at(offsets.at(op))->rawStringer().c_str());
+        int off = operand(ip);
+        printf("%10d %5d: %s %10d %s\n", pc, line(pc),
+               byte::codeString[co].c_str(), off,
+               constants.at(off)->rawStringer().c_str());
       } break;
       case byte::GET:
+      case byte::GET_W:
       case byte::SET:
       case byte::MOD:
       case byte::DEL:
       case byte::USE: {
-        printf("%10d %5d: %s %12d '%s'\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++),
-               names.at(offsets.at(op)).c_str());
+        int off = operand(ip);
+        printf("%10d %5d: %s %12d '%s'\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str());
       } break;
       case byte::CALL: {
-        printf("%10d %5d: %s %11d\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++));
+        printf("%10d %5d: %s %11d\n", pc, line(pc),
+               byte::codeString[co].c_str(), operand(ip));
+      } break;
+      case byte::TEMP: {
+        int off = operand(ip);
+        printf("%10d %5d: %s %11d '%s'\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str());
+      } break;
+      case byte::REPLACE_L:
+      case byte::REPLACE_U:
+      case byte::INDEX_L: {
+        int off = operand(ip);
+        printf("%10d %5d: %s %6d '%s'\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str());
+      } break;
+      case byte::SLICE:
+      case byte::ITER_INIT: {
+        printf("%10d %5d: %s %6d\n", pc, line(pc),
+               byte::codeString[co].c_str(), operand(ip));
+      } break;
+      case byte::ITER_NEXT: {
+        int slot = operand(ip);
+        int k = operand(ip);
+        int v = operand(ip);
+        printf("%10d %5d: %s %6d '%s' '%s' %d\n", pc, line(pc),
+               byte::codeString[co].c_str(), slot, names.at(k).c_str(),
+               names.at(v).c_str(), operand(ip));
+      } break;
+      case byte::PAR: {
+        int off = operand(ip);
+        int k = operand(ip);
+        int v = operand(ip);
+        printf("%10d %5d: %s %12d %s '%s' '%s'\n", pc, line(pc),
+               byte::codeString[co].c_str(), off,
+               constants.at(off)->rawStringer().c_str(), names.at(k).c_str(),
+               names.at(v).c_str());
+      } break;
+      case byte::TAIL_CALL: {
+        printf("%10d %5d: %s %6d\n", pc, line(pc),
+               byte::codeString[co].c_str(), operand(ip));
       } break;
       case byte::B_ARR:
       case byte::B_TUP:
       case byte::B_MAP: {
-        printf("%10d %5d: %s %10d\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++));
+        printf("%10d %5d: %s %10d\n", pc, line(pc),
+               byte::codeString[co].c_str(), operand(ip));
       } break;
       case byte::F_JUMP:
       case byte::T_JUMP: {
-        printf("%10d %5d: %s %9d\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++));
+        printf("%10d %5d: %s %9d\n", pc, line(pc),
+               byte::codeString[co].c_str(), operand(ip));
       } break;
       case byte::JUMP: {
-        printf("%10d %5d: %s %11d\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op++));
+        printf("%10d %5d: %s %11d\n", pc, line(pc),
+               byte::codeString[co].c_str(), operand(ip));
+      } break;
+      case byte::R_ASSIGN:
+      case byte::R_PUSH:
+      case byte::R_F_JUMP:
+      case byte::R_T_JUMP: {
+        std::string op = byte::codeString[operand(ip)];
+        std::string d = co == byte::R_ASSIGN ? "'" + names.at(operand(ip)) + "'"
+                                             : "";
+        std::string x = value(operand(ip));
+        std::string y = value(operand(ip));
+
+        printf("%10d %5d: %s %6s %s %s %s", pc, line(pc),
+               byte::codeString[co].c_str(), op.c_str(), d.c_str(), x.c_str(),
+               y.c_str());
+        if (co == byte::R_F_JUMP || co == byte::R_T_JUMP)
+          printf(" %d", operand(ip));
+        printf("\n");
+      } break;
+      case byte::R_MOVE: {
+        int off = operand(ip);
+        std::string x = value(operand(ip));
+        printf("%10d %5d: %s %9d '%s' %s\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str(),
+               x.c_str());
       } break;
       case byte::NEW: {
-        printf("%10d %5d: %s %12d '%s' %d\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str(), offsets.at(op),
-               names.at(offsets.at(op)).c_str(), offsets.at(op + 1));
-        op += 2;
+        int off = operand(ip);
+        int count = operand(ip);
+        printf("%10d %5d: %s %12d '%s' %d\n", pc, line(pc),
+               byte::codeString[co].c_str(), off, names.at(off).c_str(),
+               count);
       } break;
       default:
-        printf("%10d %5d: %s\n", ip, lineno.at(ip),
-               byte::codeString[codes.at(ip)].c_str());
+        printf("%10d %5d: %s\n", pc, line(pc), byte::codeString[co].c_str());
         break;
       }
     }
-
-    // std::cout << "CONSTANT: " << std::endl;
-    // if (constants.empty()) {
-    //   printf("%20s\n", "EMPTY");
-    // } else {
-    //   for (int i = 0; i < constants.size(); i++) {
-    //     printf("%20d: %s\n", i, constants.at(i)->rawStringer().c_str());
-    //   }
-    // }
-
-    // std::cout << "NAME: " << std::endl;
-    // if (names.empty()) {
-    //   printf("%20s\n", "EMPTY");
-    // } else {
-    //   for (int i = 0; i < names.size(); i++) {
-    //     if (i % 4 == 0) {
-    //       printf("%20d: '%s'\t", i, names.at(i).c_str());
-    //     } else {
-    //       printf("%5d: '%s' \t", i, names.at(i).c_str());
-    //     }
-    //     if ((i + 1) % 4 == 0) {
-    //       printf("\n");
-    //     }
-    //   }
-    //   printf("\n");
-    // }
-
-    // std::cout << "OFFSET: " << std::endl;
-    // if (offsets.empty()) {
-    //     printf("%20s\n", "EMPTY");
-    // } else {
-    //     for (int i = 0; i < offsets.size(); i++) {
-    //         if (i % 4 == 0) {
-    //             printf("%20d: %d \t", i, offsets.at(i));
-    //         } else {
-    //             printf("%5d: %d  \t", i, offsets.at(i));
-    //         }
-    //         if ((i + 1) % 4 == 0) {
-    //             printf("\n");
-    //         }
-    //     }
-    //     printf("\n");
-    // }
-
-    // std::cout << "TYPE: " << std::endl;
-    // if (types.empty()) {
-    //   printf("%20s\n", "EMPTY");
-    // } else {
-    //   for (int i = 0; i < types.size(); i++) {
-    //     printf("%20d: %s\n", i, types.at(i)->stringer().c_str());
-    //   }
-    // }
   }
 };
 
@@ -24,7 +24,7 @@
 // exceptions
 namespace exp {
 // total number of exceptions
-constexpr int len = 12;
+constexpr int len = 13;
 // exception type
 enum Kind {
   // LEXER
@@ -41,6 +41,7 @@ enum Kind {
   CANNOT_PUBLIC, // can not to public
   ENUMERATION,   // whole body not definition of enum
   CALL_INHERIT,  // can only be with call expr
+  SHARED_WRITE,  // parallel loop writes what is not its own
   //
   RUNTIME_ERROR,
 };
@@ -49,24 +50,25 @@ enum Kind {
 static std::string kindString[len] = {
     "UNKNOWN_SYMBOL", "CHARACTER_EXP", "STRING_EXP",   "UNEXPECTED",
     "INVALID_SYNTAX", "INCREMENT_OP",  "TYPE_ERROR",   "DIVISION_ZERO",
-    "CANNOT_PUBLIC",  "ENUMERATION",   "CALL_INHERIT", "RUNTIME_ERROR",
+    "CANNOT_PUBLIC",  "ENUMERATION",   "CALL_INHERIT", "SHARED_WRITE",
+    "RUNTIME_ERROR",
 };
 
 // exception structure
 class Exp : public std::exception {
 private:
-  // state
-  State *state;
+  // copy of state, the interpreter goes on after it is thrown
+  State state;
 
 public:
-  explicit Exp(State *state) { this->state = state; }
+  explicit Exp(State *state) : state(*state) {}
 
   // return a string of exception structure
   std::string stringer() {
     std::stringstream str;
 
-    str << kindString[state->kind] << " AT " << state->filePath;
-    str << ":" << state->line << "\t" << state->message;
+    str << kindString[state.kind] << " AT " << state.filePath;
+    str << ":" << state.line << "\t" << state.message;
 
     return str.str();
   }
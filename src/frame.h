@@ -18,18 +18,90 @@
 #include "stack.h"
 #include "table.h"
 
+// state of for-in loop
+struct Iter {
+  object::Object *obj = nullptr; // held while iterated
+  int pos = 0;                   // next element
+
+  std::map<object::Object *, object::Object *>::iterator at; // next of map
+};
+
+// bytes of scratch of frame, allocations beyond it are on heap
+constexpr int scratchSize = 4096;
+
 // frame structure
 struct Frame {
   Entity *entity; // ENTITY
 
   Table tb; // SYMBOL
 
-  Stack<object::Object *> data;  // DATA
-  object::Object *ret = nullptr; // RETURN
+  Window<object::Object *> data; // DATA
+  object::Object *ret = nullptr;  // RETURN
+  object::Object *up = nullptr;   // WHOLE OF METHOD, ITS TABLE IS PARENT
 
   std::string mod; // MODULE NAME
 
+  std::vector<Iter> iters; // ITERATOR OF LOOP DEPTH
+
+  bool gen = false; // FRAME OF GENERATOR
+  int ip = 0;       // POSITION TO RESUME, 0 IF NOT SUSPENDED
+
+  char *scratch = nullptr;              // OBJECTS NOT ESCAPING
+  int used = 0;                         // BYTES OF SCRATCH TAKEN
+  std::vector<object::Object *> locals; // OBJECTS IN SCRATCH
+
   explicit Frame(Entity *e) : entity(e) {}
+
+  ~Frame() {
+    this->clean();
+    delete[] this->scratch;
+  }
+
+  // frames are allocated from slabs of their size
+  static void *operator new(std::size_t n) { return slab::alloc(n); }
+  static void operator delete(void *p, std::size_t n) { slab::free(p, n); }
+
+  // reset a frame to be reused
+  void reset(Entity *e) {
+    this->entity = e;
+    this->drop();
+    this->tb.parent = nullptr;
+    this->ret = nullptr;
+    this->up = nullptr;
+    this->mod.clear();
+    this->gen = false;
+    this->ip = 0;
+  }
+
+  // release names and iterated objects
+  void drop() {
+    this->tb.clear();
+    for (auto &i : this->iters)
+      object::release(i.obj);
+    this->iters.clear();
+    this->clean();
+  }
+
+  // memory of size in scratch, nullptr if it is full
+  void *take(std::size_t n) {
+    n = (n + 15) & ~15; // ALIGN
+    if (this->used + n > scratchSize)
+      return nullptr;
+    if (this->scratch == nullptr)
+      this->scratch = new char[scratchSize];
+
+    void *p = this->scratch + this->used;
+    this->used += n;
+    return p;
+  }
+
+  // destroy objects in scratch, as the frame returns
+  void clean() {
+    for (auto i : this->locals)
+      i->~Object();
+    this->locals.clear();
+    this->used = 0;
+  }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,305 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "entity.h"
+#include "frame.h"
+#include "gc.h"
+
+namespace gc {
+thread_local Heap *current = nullptr;
+
+constexpr int stride = 4096; // allocations between slices of a cycle
+constexpr int every = 64;    // objects between readings of clock
+
+using clock = std::chrono::steady_clock;
+
+void track(object::Object *o) {
+  Heap *h = current;
+  if (h == nullptr)
+    return; // PERMANENT, OUT OF RUNTIME
+
+  if (h->phase == IDLE) {
+    h->young.push_back(o);
+    if (h->young.size() >= h->nursery && !h->arena)
+      h->pending = true;
+  } else {
+    h->tenured.push_back(o); // DURING CYCLE
+    if (++h->debt >= stride)
+      h->pending = true;
+  }
+}
+
+void write(object::Object *o) {
+  if (current == nullptr || current->phase != IDLE || current->arena ||
+      o == nullptr || !o->old || o->remembered)
+    return;
+  o->remembered = true;
+  current->rset.push_back(o);
+}
+
+static void scan(object::Object *);
+
+void shade(object::Object *o) {
+  if (o != nullptr && o->local) {
+    scan(o); // NOT COLLECTED, ITS REFERENCES ARE
+    return;
+  }
+  if (o == nullptr || o->color != WHITE || (current->minor && o->old))
+    return;
+  o->color = GRAY;
+  current->gray.push_back(o);
+}
+
+void mark(Entity *e) {
+  if (e == nullptr)
+    return;
+  for (auto i : e->constants)
+    shade(i);
+}
+
+void mark(Frame *f) {
+  for (auto &i : f->tb.symbols)
+    shade(i.second);
+  shade(f->ret);
+  shade(f->up);
+  for (auto &i : f->iters)
+    shade(i.obj);
+  mark(f->entity);
+}
+
+// references of object to gray
+static void scan(object::Object *o) {
+  switch (o->kind()) {
+  case object::ARRAY: {
+    object::Array *a = static_cast<object::Array *>(o);
+    shade(a->view);
+    for (auto i : a->elements)
+      shade(i);
+  } break;
+  case object::TUPLE:
+    for (auto i : static_cast<object::Tuple *>(o)->elements)
+      shade(i);
+    break;
+  case object::MAP:
+    for (auto &i : static_cast<object::Map *>(o)->elements) {
+      shade(i.first);
+      shade(i.second);
+    }
+    break;
+  case object::FUNC:
+    mark(static_cast<object::Func *>(o)->entity);
+    break;
+  case object::GEN: {
+    object::Gen *g = static_cast<object::Gen *>(o);
+    shade(g->func);
+    if (g->frame != nullptr)
+      mark(g->frame);
+  } break;
+  case object::WHOLE: {
+    object::Whole *w = static_cast<object::Whole *>(o);
+    mark(w->entity);
+    if (w->f != nullptr)
+      mark(w->f);
+  } break;
+  case object::MODULE:
+    mark(static_cast<object::Module *>(o)->f);
+    break;
+  case object::MODS:
+    for (auto i : static_cast<object::Mods *>(o)->mods)
+      shade(i);
+    break;
+  default:
+    break; // NO REFERENCES, VALUES OF CHANNEL ARE IN HEAPS OF THEIR OWN
+  }
+}
+
+// gray to black, its references to gray
+static void blacken(object::Object *o) {
+  o->color = BLACK;
+  scan(o);
+}
+
+// microseconds since
+static long since(clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() -
+                                                               t)
+      .count();
+}
+
+// scan gray objects until none or out of time, return whether none
+static bool drain(Heap *h, clock::time_point t, bool bounded) {
+  for (int n = 1; !h->gray.empty(); n++) {
+    object::Object *o = h->gray.back();
+    h->gray.pop_back();
+    blacken(o);
+
+    if (bounded && n % every == 0 && since(t) >= h->pause)
+      return false;
+  }
+  return true;
+}
+
+// frame owned by object, not shared with others
+static void freeFrame(object::Object *o) {
+  Frame *f = nullptr;
+  if (o->kind() == object::WHOLE)
+    f = static_cast<object::Whole *>(o)->f;
+  if (o->kind() == object::GEN)
+    f = static_cast<object::Gen *>(o)->frame;
+  delete f;
+}
+
+// free all objects, the runtime is gone
+Heap::~Heap() {
+  for (auto v : {&this->tenured, &this->young})
+    for (auto i : *v) {
+      freeFrame(i);
+      delete i;
+    }
+}
+
+// free white objects until the end or out of time, return whether ended
+static bool sweep(Heap *h, clock::time_point t) {
+  for (int n = 1; h->cursor < h->end; n++) {
+    object::Object *o = h->tenured[h->cursor++];
+
+    if (o->color == WHITE) {
+      freeFrame(o);
+      delete o;
+      h->freed++;
+    } else {
+      o->color = WHITE; // FOR NEXT CYCLE
+      h->tenured[h->kept++] = o;
+    }
+
+    if (n % every == 0 && since(t) >= h->pause)
+      return false;
+  }
+  // NEWER ONES
+  h->tenured.erase(h->tenured.begin() + h->kept, h->tenured.begin() + h->end);
+  return true;
+}
+
+// free dead young objects and promote the others, not incremental as the
+// nursery is small
+static void collect(Heap *h, const std::function<void()> &roots) {
+  h->minor = true;
+  roots();
+  for (auto i : h->rset) {
+    scan(i);
+    i->remembered = false;
+  }
+  h->rset.clear();
+  drain(h, clock::now(), false);
+  h->minor = false;
+
+  for (auto i : h->young)
+    if (i->color == WHITE) {
+      freeFrame(i);
+      delete i;
+      h->freed++;
+    } else {
+      i->color = WHITE;
+      i->old = true; // PROMOTE
+      h->tenured.push_back(i);
+      h->promoted++;
+    }
+  h->young.clear();
+  h->minors++;
+}
+
+void step(const std::function<void()> &roots) {
+  Heap *h = current;
+  clock::time_point t = clock::now();
+  h->pending = false;
+  h->debt = 0;
+
+  switch (h->phase) {
+  case IDLE:
+    collect(h, roots); // MINOR
+    if (h->tenured.size() < h->threshold)
+      break;
+
+    // START, NURSERY IS EMPTY UNTIL THE END OF CYCLE
+    h->phase = MARK;
+    h->fresh = BLACK;
+    h->tenure = true;
+    h->cycles++;
+
+    roots();
+    drain(h, t, true);
+    break;
+
+  case MARK:
+    if (!drain(h, t, true))
+      break;
+    // ATOMIC, roots are written without barrier
+    roots();
+    drain(h, t, false);
+
+    h->phase = SWEEP;
+    h->fresh = WHITE;
+    h->cursor = h->kept = 0;
+    h->end = h->tenured.size();
+    break;
+
+  case SWEEP:
+    if (!sweep(h, t))
+      break;
+    h->phase = IDLE;
+    h->tenure = false;
+    h->threshold = std::max<size_t>(h->least, h->tenured.size() * 2);
+    break;
+  }
+
+  long us = since(t);
+  int k = 0;
+  while (k < buckets - 1 && (1L << k) <= us)
+    k++;
+  h->hist[k]++;
+  h->slices++;
+  h->longest = std::max(h->longest, us);
+}
+
+void adopt(Heap *from) {
+  for (auto v : {&from->tenured, &from->young}) {
+    for (auto i : *v) {
+      i->color = current->fresh;
+      i->old = current->tenure;
+      track(i);
+    }
+    v->clear();
+  }
+}
+
+void dissemble() {
+  Heap *h = current;
+  printf("GC: \n");
+  printf("%10s %10s %12s %12s %12s %12s %12s\n", "MINORS", "CYCLES",
+         "SLICES", "PROMOTED", "FREED", "LIVE", "LONGEST");
+  printf("%10ld %10ld %12ld %12ld %12ld %12zu %10ldus\n", h->minors,
+         h->cycles, h->slices, h->promoted, h->freed,
+         h->tenured.size() + h->young.size(), h->longest);
+
+  printf("PAUSE: \n");
+  for (int k = 0; k < buckets; k++)
+    if (h->hist[k] != 0)
+      printf("%8s%8ldus %12ld\n", "<", 1L << k, h->hist[k]);
+}
+}; // namespace gc
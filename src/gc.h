@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_GC_H
+#define DRIFT_GC_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace object {
+class Object;
+};
+struct Entity;
+struct Frame;
+
+// generational and incremental tri-color collector of runtime objects
+//
+// new objects are young in the nursery, a minor collection frees the dead
+// ones and promotes the others, old objects refer young ones only if they
+// were written after the last minor one, such objects are remembered
+//
+// old objects are collected by cycles of marking and sweeping, which run in
+// slices at the safe points of vm, each slice stops once it takes the pause
+// target, objects stored while marking are shaded by the write barrier so
+// that a black one never refers a white one
+//
+// each runtime has its own heap, the current one is selected per thread
+//
+namespace gc {
+enum Color : unsigned char { WHITE, GRAY, BLACK };
+enum Phase { IDLE, MARK, SWEEP };
+
+constexpr int buckets = 24; // pauses up to 2^23 microseconds
+
+// objects and collector of a runtime, not shared with other runtimes
+struct Heap {
+  Phase phase = IDLE;     // phase of current cycle
+  Color fresh = WHITE;    // color of new objects, black while marking
+  bool tenure = false;    // new objects are old, while a cycle runs
+  // slice to do at the next safe point, set by other threads to stop a task
+  std::atomic<bool> pending{false};
+  int pause = 500;        // target of each slice, microseconds
+  int least = 64 * 1024;  // fewest objects to start a cycle
+  int nursery = 4 * 1024; // young objects of a minor collection
+
+  // of a parallel loop, never collected and freed as a whole, objects of
+  // other heaps are read only to it
+  bool arena = false;
+
+  std::vector<object::Object *> tenured; // OLD OBJECTS
+  std::vector<object::Object *> young;   // NURSERY
+  std::vector<object::Object *> gray;    // TO BE SCANNED
+  std::vector<object::Object *> rset;    // REMEMBERED OLD OBJECTS
+
+  bool minor = false; // in minor collection, old ones are not scanned
+
+  size_t threshold = least; // objects to start next cycle
+  int debt = 0;             // allocations since last slice
+
+  size_t cursor = 0; // next to sweep
+  size_t end = 0;    // objects before sweeping, newer ones are kept
+  size_t kept = 0;   // survivors moved to the front
+
+  long cycles = 0, freed = 0, slices = 0;
+  long minors = 0, promoted = 0;
+  long hist[buckets] = {}; // slices of pause below 2^k microseconds
+  long longest = 0;        // microseconds
+
+  Heap() = default;
+  Heap(const Heap &) = delete;
+  ~Heap(); // free all objects
+};
+
+// heap of the runtime on current thread, new objects are tracked by it
+//
+// objects made out of any runtime are permanent, they are black and never
+// written by a collector, so that compiled constants are shared read only
+// by the runtimes of all threads
+extern thread_local Heap *current;
+
+// heap is the current one of thread, until end of scope
+struct Scope {
+  Heap *prev;
+
+  explicit Scope(Heap *h) : prev(current) { current = h; }
+  ~Scope() { current = prev; }
+};
+
+void track(object::Object *); // new object to be collected
+
+void write(object::Object *); // object is written, remembered if old
+void shade(object::Object *); // white to gray
+void mark(Frame *);           // names, return and iterated objects of frame
+void mark(Entity *);          // constants of entity
+
+// color of new object
+inline Color fresh() { return current != nullptr ? current->fresh : BLACK; }
+
+// new object is old, while a cycle runs
+inline bool tenure() { return current != nullptr && current->tenure; }
+
+// new object is made in an arena
+inline bool arena() { return current != nullptr && current->arena; }
+
+// new object is made out of any runtime
+inline bool permanent() { return current == nullptr; }
+
+// write barrier, object is stored into a name or element
+inline void barrier(object::Object *o) {
+  if (current != nullptr && current->phase == MARK && o != nullptr)
+    shade(o);
+}
+
+// one slice of collection, roots are marked by the function
+void step(const std::function<void()> &);
+
+// objects of the other heap moved into current one as new ones, so that a
+// heap of values sent to a channel is handed to the receiver
+void adopt(Heap *);
+
+void dissemble(); // output statistics and histogram of pauses
+}; // namespace gc
+
+#endif
@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#include <cctype>
+
+#include "http.h"
+
+namespace http {
+constexpr size_t none = std::string_view::npos;
+
+// equal ignoring case
+bool same(std::string_view a, std::string_view b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); i++)
+    if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i]))
+      return false;
+  return true;
+}
+
+// without spaces and tabs of both sides
+static std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    s.remove_suffix(1);
+  return s;
+}
+
+// line from position to next LF without its CR, position after it or none
+static size_t line(std::string_view s, size_t at, std::string_view *l) {
+  size_t e = s.find('\n', at);
+  if (e == none)
+    return none;
+  size_t end = e > at && s[e - 1] == '\r' ? e - 1 : e;
+  *l = s.substr(at, end - at);
+  return e + 1;
+}
+
+// request at front of bytes, its length, 0 if it is not complete, -1 if it
+// is malformed or its length is ambiguous, -2 if its transfer coding is not
+// implemented
+int parse(std::string_view s, Request *r) {
+  r->headers.clear(); // KEEPS ITS CAPACITY
+  r->body = {};
+
+  std::string_view l;
+  size_t at = line(s, 0, &l);
+  if (at == none)
+    return 0;
+
+  // METHOD PATH VERSION
+  size_t a = l.find(' ');
+  size_t b = l.rfind(' ');
+  if (a == none || a == 0 || b <= a + 1)
+    return -1;
+  r->method = l.substr(0, a);
+  r->path = l.substr(a + 1, b - a - 1);
+
+  std::string_view v = l.substr(b + 1);
+  if (v == "HTTP/1.1")
+    r->keep = true;
+  else if (v == "HTTP/1.0")
+    r->keep = false; // UNLESS IT ASKS
+  else
+    return -1;
+  r->old = v == "HTTP/1.0";
+
+  size_t length = 0;
+  bool sized = false, coded = false; // OF ANY ORDER OF HEADERS
+  while (true) {
+    at = line(s, at, &l);
+    if (at == none)
+      return 0;
+    if (l.empty())
+      break; // END OF HEADERS
+
+    size_t c = l.find(':');
+    if (c == none || c == 0)
+      return -1;
+    std::string_view k = l.substr(0, c);
+    std::string_view v = trim(l.substr(c + 1));
+    r->headers.emplace_back(k, v);
+
+    if (same(k, "content-length")) {
+      if (v.empty() || v.size() > 9)
+        return -1;
+      size_t n = 0;
+      for (char i : v) {
+        if (!std::isdigit((unsigned char)i))
+          return -1;
+        n = n * 10 + (i - '0');
+      }
+      if (sized && n != length)
+        return -1; // WHICH ONE ENDS THE BODY
+      length = n;
+      sized = true;
+    } else if (same(k, "connection")) {
+      if (same(v, "close"))
+        r->keep = false;
+      else if (same(v, "keep-alive"))
+        r->keep = true;
+    } else if (same(k, "transfer-encoding"))
+      coded = true;
+  }
+  if (coded)
+    return sized ? -1 : -2; // SMUGGLING, OR CHUNKED BODY IS NOT SUPPORTED
+  if (s.size() - at < length)
+    return 0; // PART OF BODY
+  r->body = s.substr(at, length);
+  return at + length;
+}
+
+// reason phrase of status, empty if it is not known
+static const char *reason(int status) {
+  switch (status) {
+  case 200:
+    return "OK";
+  case 201:
+    return "Created";
+  case 204:
+    return "No Content";
+  case 301:
+    return "Moved Permanently";
+  case 302:
+    return "Found";
+  case 304:
+    return "Not Modified";
+  case 400:
+    return "Bad Request";
+  case 401:
+    return "Unauthorized";
+  case 403:
+    return "Forbidden";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 413:
+    return "Content Too Large";
+  case 500:
+    return "Internal Server Error";
+  case 501:
+    return "Not Implemented";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "";
+  }
+}
+
+// response of status, header fields and body appended to output
+void respond(std::string &out, int status, std::string_view body, bool keep,
+             const Fields &fields, bool old) {
+  // NO CONTENT OF INFORMATIONAL, 204 AND 304
+  bool empty = status < 200 || status == 204 || status == 304;
+
+  out += "HTTP/1.1 ";
+  out += std::to_string(status);
+  out += ' ';
+  out += reason(status);
+  out += "\r\n";
+
+  bool typed = false;
+  for (auto &i : fields) {
+    if (same(i.first, "content-length") || same(i.first, "connection") ||
+        same(i.first, "transfer-encoding"))
+      continue; // OF SERVER
+    typed = typed || same(i.first, "content-type");
+    out += i.first;
+    out += ": ";
+    out += i.second;
+    out += "\r\n";
+  }
+  if (!typed && !empty)
+    out += "Content-Type: text/plain; charset=utf-8\r\n";
+  if (!empty) {
+    out += "Content-Length: ";
+    out += std::to_string(body.size());
+    out += "\r\n";
+  }
+  if (!keep)
+    out += "Connection: close\r\n";
+  else if (old)
+    out += "Connection: keep-alive\r\n"; // NOT KEPT BY DEFAULT OF HTTP/1.0
+  out += "\r\n";
+  if (!empty)
+    out += body;
+}
+}; // namespace http
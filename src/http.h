@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_HTTP_H
+#define DRIFT_HTTP_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// requests and responses of HTTP/1.1 server
+//
+// requests are parsed in place, their fields view the buffer of connection
+// and nothing is copied until they are given to the handler, lines may end
+// with a single LF
+//
+namespace http {
+constexpr int buffer = 16 * 1024; // bytes of connection, larger are refused
+
+// request of connection, views of its buffer
+struct Request {
+  std::string_view method, path, body;
+  std::vector<std::pair<std::string_view, std::string_view>> headers;
+  bool keep = true; // connection is kept alive after response
+  bool old = false; // of HTTP/1.0, its keeping alive is told in response
+};
+
+// header fields of response, of handler
+using Fields = std::vector<std::pair<std::string, std::string>>;
+
+// request at front of bytes, its length, 0 if it is not complete, -1 if it
+// is malformed or its length is ambiguous, -2 if its transfer coding is not
+// implemented
+int parse(std::string_view, Request *);
+
+// response of status, header fields and body appended to output, its
+// content type is plain text unless fields have one, content length and
+// connection are always of server, a kept HTTP/1.0 connection is told so
+void respond(std::string &, int, std::string_view, bool,
+             const Fields & = Fields(), bool = false);
+
+bool same(std::string_view, std::string_view); // equal ignoring case
+}; // namespace http
+
+#endif
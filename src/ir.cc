@@ -0,0 +1,1204 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#include "ir.h"
+
+namespace ir {
+
+// bytecode of jump, its operand is the offset
+static bool isJump(byte::Code co) {
+  return co == byte::JUMP || co == byte::F_JUMP || co == byte::T_JUMP ||
+         co == byte::ITER_NEXT;
+}
+
+// bytecode may rebind any name of current frame
+static bool isBarrier(byte::Code co) {
+  return co == byte::USE || co == byte::SET || co == byte::GET_W ||
+         co == byte::FUNC ||
+         co == byte::WHOLE || co == byte::ENUM || co == byte::TAIL_CALL ||
+         co == byte::ITER_NEXT || co == byte::PAR;
+}
+
+// bytecode binds the name of its first operand
+static bool isDef(byte::Code co) {
+  return co == byte::ASSIGN || co == byte::STORE || co == byte::DEL ||
+         co == byte::TEMP;
+}
+
+// bytecode binds or changes in place the name of its first operand
+static bool isWrite(byte::Code co) {
+  return isDef(co) || co == byte::REPLACE_L || co == byte::REPLACE_U ||
+         co == byte::INDEX_L;
+}
+
+// arithmetic and comparison of numbers
+static bool isArith(byte::Code co) {
+  return co == byte::ADD || co == byte::SUB || co == byte::MUL ||
+         co == byte::DIV || co == byte::SUR || co == byte::GR ||
+         co == byte::GR_E || co == byte::LE || co == byte::LE_E;
+}
+
+// constant of number
+static bool isNumber(object::Object *obj) {
+  return obj->kind() == object::INT || obj->kind() == object::FLOAT;
+}
+
+// values popped and pushed by bytecode
+static void effect(Entity *e, Ins &i, int depth, int *pop, int *push) {
+  *pop = 0;
+  *push = 0;
+
+  switch (i.co) {
+  case byte::CONST:
+  case byte::LOAD:
+  case byte::NAME:
+  case byte::ORIG: // STORE takes it
+    *push = 1;
+    break;
+  case byte::ASSIGN:
+  case byte::STORE:
+  case byte::TEMP:
+  case byte::ITER_INIT:
+  case byte::YIELD:
+  case byte::PAR:
+  case byte::F_JUMP:
+  case byte::T_JUMP:
+    *pop = 1;
+    break;
+  case byte::INDEX:
+  case byte::INDEX_U:
+  case byte::INDEX_W:
+    *pop = 2;
+    *push = 1;
+    break;
+  case byte::REPLACE:
+    *pop = 3;
+    break;
+  case byte::SLICE:
+    *pop = 1 + (i.ops.front() & 1) + (i.ops.front() >> 1);
+    *push = 1;
+    break;
+  case byte::GET:
+  case byte::GET_W:
+  case byte::INDEX_L:
+  case byte::BANG:
+  case byte::NOT:
+    *pop = 1;
+    *push = 1;
+    break;
+  case byte::SET:
+  case byte::REPLACE_L:
+  case byte::REPLACE_U:
+    *pop = 2;
+    break;
+  case byte::CALL:
+  case byte::TAIL_CALL:
+    *pop = i.ops.front() + 1;
+    *push = 1; // RESULT OR NOTHING, NEVER POPPED IF NOTHING
+    break;
+  case byte::NEW:
+  case byte::B_ARR:
+  case byte::B_TUP:
+  case byte::B_MAP:
+    *pop = i.ops.back();
+    *push = 1;
+    break;
+  case byte::FUNC:
+    if (static_cast<object::Func *>(e->constants.at(i.ops.front()))->name ==
+        "anonymouse")
+      *push = 1;
+    break;
+  case byte::RET:
+    *pop = depth; // ALL
+    break;
+  default:
+    if (isArith(i.co) || i.co == byte::E_E || i.co == byte::N_E ||
+        i.co == byte::AND || i.co == byte::OR) {
+      *pop = 2;
+      *push = 1;
+    }
+    break;
+  }
+}
+
+// split entity into blocks, nullptr if the stack is not balanced
+Func *lift(Entity *e, std::map<std::string, Type *> params) {
+  if (e->codes.empty())
+    return nullptr;
+
+  std::vector<Ins> list; // DECODE
+  std::set<int> leaders = {0};
+
+  for (int ip = 0; ip < e->codes.size();) {
+    Ins i;
+    i.pc = ip;
+    i.co = (byte::Code)e->codes.at(ip++);
+    i.line = e->line(i.pc);
+
+    for (int k = 0; k < byte::codeOperands[i.co]; k++)
+      i.ops.push_back(e->operand(ip));
+
+    if (i.co >= byte::R_ASSIGN)
+      return nullptr; // THREE ADDRESS
+    if (isJump(i.co)) {
+      leaders.insert(i.ops.back());
+      leaders.insert(ip);
+    }
+    if (i.co == byte::RET || i.co == byte::RET_N)
+      leaders.insert(ip);
+
+    list.push_back(i);
+  }
+
+  Func *f = new Func;
+  f->entity = e;
+  f->params = params;
+
+  std::map<int, int> at; // position to block
+  for (auto &i : list) {
+    if (leaders.count(i.pc)) {
+      at[i.pc] = f->blocks.size();
+      f->blocks.push_back(Block{i.pc});
+    }
+    f->blocks.back().code.push_back(i);
+  }
+
+  // SUCCESSORS
+  for (int b = 0; b < f->blocks.size(); b++) {
+    Ins &last = f->blocks.at(b).code.back();
+
+    if (isJump(last.co) && at.count(last.ops.back()))
+      f->blocks.at(b).succs.push_back(at.at(last.ops.back())); // TO
+    if (last.co != byte::JUMP && last.co != byte::RET &&
+        last.co != byte::RET_N && b + 1 < f->blocks.size())
+      f->blocks.at(b).succs.push_back(b + 1); // NEXT
+  }
+
+  // STACK OF EACH BLOCK
+  std::vector<int> depth(f->blocks.size(), -1);
+  std::vector<int> work = {0};
+  depth.at(0) = 0;
+
+  while (!work.empty()) {
+    Block &b = f->blocks.at(work.back());
+    work.pop_back();
+
+    b.reachable = true;
+
+    std::vector<int> stack;
+    for (int k = 0; k < depth.at(&b - &f->blocks.front()); k++) {
+      b.params.push_back(f->values);
+      stack.push_back(f->values++);
+    }
+
+    for (auto &i : b.code) {
+      int pop, push;
+      effect(e, i, stack.size(), &pop, &push);
+
+      if (pop > stack.size()) {
+        delete f;
+        return nullptr; // NOT BALANCED
+      }
+      i.args.assign(stack.end() - pop, stack.end());
+      stack.resize(stack.size() - pop);
+
+      if (push) {
+        i.def = f->values++;
+        stack.push_back(i.def);
+      }
+    }
+    b.outs = stack;
+
+    for (auto s : b.succs) {
+      if (depth.at(s) == -1) {
+        depth.at(s) = stack.size();
+        work.push_back(s);
+      } else if (depth.at(s) != stack.size()) {
+        delete f;
+        return nullptr; // NOT BALANCED
+      }
+    }
+  }
+
+  for (auto &b : f->blocks) {
+    f->live.insert(b.params.begin(), b.params.end());
+    f->live.insert(b.outs.begin(), b.outs.end());
+  }
+  return f;
+}
+
+// the instruction defines value in block, -1 if not in
+static int defOf(Block &b, int v) {
+  for (int i = 0; i < b.code.size(); i++)
+    if (!b.code.at(i).dead && b.code.at(i).def == v)
+      return i;
+  return -1;
+}
+
+// remove the instructions compute value and its operands in block
+static void kill(Block &b, int v) {
+  int i = defOf(b, v);
+  if (i == -1)
+    return;
+  b.code.at(i).dead = true;
+
+  for (auto a : b.code.at(i).args)
+    kill(b, a);
+}
+
+// number of uses of each value
+static std::map<int, int> uses(Func *f) {
+  std::map<int, int> n;
+  for (auto &b : f->blocks) {
+    for (auto &i : b.pre)
+      for (auto a : i.args)
+        n[a]++;
+    for (auto &i : b.code)
+      if (!i.dead)
+        for (auto a : i.args)
+          n[a]++;
+  }
+  for (auto v : f->live)
+    n[v]++;
+  return n;
+}
+
+// a new temporary name in entity
+static int newTemp(Func *f) {
+  f->entity->names.push_back("%t" + std::to_string(f->temps++));
+  return f->entity->names.size() - 1;
+}
+
+// fold operator of two number constants, nullptr if it can't
+static object::Object *fold(byte::Code co, object::Object *x,
+                            object::Object *y) {
+#define FOLD_OP(TI, TF, OP)                                                    \
+  if (x->kind() == object::INT) {                                              \
+    int l = static_cast<object::Int *>(x)->value;                              \
+    if (y->kind() == object::INT)                                              \
+      return new TI(l OP static_cast<object::Int *>(y)->value);                \
+    return new TF(l OP static_cast<object::Float *>(y)->value);                \
+  } else {                                                                     \
+    double l = static_cast<object::Float *>(x)->value;                         \
+    if (y->kind() == object::INT)                                              \
+      return new TF(l OP static_cast<object::Int *>(y)->value);                \
+    return new TF(l OP static_cast<object::Float *>(y)->value);                \
+  }
+
+  if (!isNumber(x) || !isNumber(y))
+    return nullptr;
+
+  switch (co) {
+  case byte::ADD:
+    FOLD_OP(object::Int, object::Float, +);
+  case byte::SUB:
+    FOLD_OP(object::Int, object::Float, -);
+  case byte::MUL:
+    FOLD_OP(object::Int, object::Float, *);
+  case byte::GR:
+    FOLD_OP(object::Bool, object::Bool, >);
+  case byte::GR_E:
+    FOLD_OP(object::Bool, object::Bool, >=);
+  case byte::LE:
+    FOLD_OP(object::Bool, object::Bool, <);
+  case byte::LE_E:
+    FOLD_OP(object::Bool, object::Bool, <=);
+  default:
+    return nullptr; // DIVISION IS LEFT TO RUNTIME
+  }
+#undef FOLD_OP
+}
+
+// constant propagation and folding
+void constant(Func *f) {
+  Entity *e = f->entity;
+
+  for (auto &b : f->blocks) {
+    std::map<std::string, int> known; // name to constant
+    std::map<int, int> value;         // value to constant
+
+    for (auto &i : b.code) {
+      if (i.dead)
+        continue;
+
+      if (isBarrier(i.co)) {
+        known.clear();
+        continue;
+      }
+
+      switch (i.co) {
+      case byte::CONST:
+        if (isNumber(e->constants.at(i.ops.front())) ||
+            e->constants.at(i.ops.front())->kind() == object::BOOL)
+          value[i.def] = i.ops.front();
+        break;
+      case byte::LOAD: {
+        auto iter = known.find(e->names.at(i.ops.front()));
+        if (iter != known.end()) {
+          i.co = byte::CONST; // LOAD OF CONSTANT
+          i.ops = {iter->second};
+          value[i.def] = iter->second;
+        }
+      } break;
+      case byte::ASSIGN:
+      case byte::STORE: {
+        std::string name = e->names.at(i.ops.front());
+        known.erase(name);
+
+        if (value.count(i.args.front()) &&
+            !f->live.count(i.args.front())) // NOT FROM OTHER BLOCK
+          known[name] = value.at(i.args.front());
+      } break;
+      case byte::DEL:
+      case byte::TEMP:
+        known.erase(e->names.at(i.ops.front()));
+        break;
+      default:
+        if (isArith(i.co) && value.count(i.args.at(0)) &&
+            value.count(i.args.at(1)) && !f->live.count(i.args.at(0)) &&
+            !f->live.count(i.args.at(1))) {
+          object::Object *r =
+              fold(i.co, e->constants.at(value.at(i.args.at(0))),
+                   e->constants.at(value.at(i.args.at(1))));
+          if (r == nullptr)
+            break;
+
+          kill(b, i.args.at(0));
+          kill(b, i.args.at(1));
+
+          e->constants.push_back(r); // FOLDED
+          i.co = byte::CONST;
+          i.ops = {(int)e->constants.size() - 1};
+          i.args.clear();
+
+          value[i.def] = i.ops.front();
+        }
+      }
+    }
+  }
+}
+
+// copy propagation of names
+void copy(Func *f) {
+  Entity *e = f->entity;
+
+  for (auto &b : f->blocks) {
+    std::map<std::string, int> copies; // name to the name it copied
+    std::map<int, int> loads;          // value to name loaded
+
+    for (auto &i : b.code) {
+      if (i.dead)
+        continue;
+
+      if (isBarrier(i.co)) {
+        copies.clear();
+        continue;
+      }
+
+      if (i.co == byte::LOAD) {
+        auto iter = copies.find(e->names.at(i.ops.front()));
+        if (iter != copies.end())
+          i.ops = {iter->second}; // LOAD OF ORIGINAL
+        loads[i.def] = i.ops.front();
+      }
+
+      if (isWrite(i.co)) {
+        std::string name = e->names.at(i.ops.front());
+
+        copies.erase(name);
+        for (auto iter = copies.begin(); iter != copies.end();)
+          if (e->names.at(iter->second) == name)
+            iter = copies.erase(iter);
+          else
+            iter++;
+
+        if ((i.co == byte::ASSIGN || i.co == byte::STORE) &&
+            loads.count(i.args.front()) && !f->live.count(i.args.front()) &&
+            e->names.at(loads.at(i.args.front())) != name)
+          copies[name] = loads.at(i.args.front());
+
+        // LOADED BEFORE, NOT A COPY OF ITS NEW VALUE OR OF NOTHING
+        for (auto iter = loads.begin(); iter != loads.end();)
+          if (e->names.at(iter->second) == name)
+            iter = loads.erase(iter);
+          else
+            iter++;
+      }
+    }
+  }
+}
+
+// key of pure value in block, empty if not pure
+static std::string keyOf(Func *f, Block &b, int v,
+                         std::map<std::string, int> &version) {
+  if (f->live.count(v))
+    return "";
+  int d = defOf(b, v);
+  if (d == -1)
+    return "";
+
+  Ins &i = b.code.at(d);
+  Entity *e = f->entity;
+
+  switch (i.co) {
+  case byte::CONST:
+    if (!isNumber(e->constants.at(i.ops.front())))
+      return "";
+    return "C" + std::to_string(i.ops.front());
+  case byte::LOAD: {
+    std::string name = e->names.at(i.ops.front());
+    return "L" + name + "@" + std::to_string(version[name]);
+  }
+  default:
+    if (!isArith(i.co))
+      return "";
+    std::string x = keyOf(f, b, i.args.at(0), version);
+    std::string y = keyOf(f, b, i.args.at(1), version);
+
+    if (x.empty() || y.empty())
+      return "";
+    // + of names may be strings which can be changed by index
+    if (i.co == byte::ADD && x.front() != 'C' && y.front() != 'C')
+      return "";
+    return byte::codeString[i.co] + "(" + x + "," + y + ")";
+  }
+}
+
+// common subexpression elimination
+void cse(Func *f) {
+  Entity *e = f->entity;
+
+  for (auto &b : f->blocks) {
+    std::map<std::string, int> version; // version of names
+    std::map<std::string, int> seen;    // key to value
+    std::map<int, int> temps;           // value to its temporary name
+
+    for (int k = 0; k < b.code.size(); k++) {
+      Ins &i = b.code.at(k);
+      if (i.dead)
+        continue;
+
+      if (isBarrier(i.co)) {
+        for (auto &v : version)
+          v.second++;
+        seen.clear();
+        continue;
+      }
+      if (isWrite(i.co)) {
+        version[e->names.at(i.ops.front())]++;
+        continue;
+      }
+      if (!isArith(i.co))
+        continue;
+
+      std::string key = keyOf(f, b, i.def, version);
+      if (key.empty())
+        continue;
+
+      auto iter = seen.find(key);
+      if (iter == seen.end()) {
+        seen[key] = i.def;
+        continue;
+      }
+
+      int v = iter->second; // SAME VALUE
+      if (!temps.count(v)) {
+        int d = defOf(b, v);
+        int t = newTemp(f);
+
+        Ins save{byte::TEMP, {t}, {v}, -1, -1, b.code.at(d).line};
+        Ins load{byte::LOAD, {t}, {}, f->values++, -1, b.code.at(d).line};
+
+        // users of value now use the load
+        for (auto &u : b.code)
+          for (auto &a : u.args)
+            if (a == v)
+              a = load.def;
+
+        b.code.insert(b.code.begin() + d + 1, {save, load});
+        k += 2;
+
+        temps[v] = t;
+        seen[key] = load.def;
+        temps[load.def] = t;
+      }
+
+      Ins &now = b.code.at(k);
+      for (auto a : now.args)
+        kill(b, a);
+
+      now.co = byte::LOAD; // LOAD OF TEMPORARY
+      now.ops = {temps.at(v)};
+      now.args.clear();
+    }
+  }
+}
+
+// name bound by FUNC, WHOLE or ENUM
+static std::string declared(Entity *e, Ins &i) {
+  object::Object *obj = e->constants.at(i.ops.front());
+
+  switch (obj->kind()) {
+  case object::FUNC:
+    return static_cast<object::Func *>(obj)->name;
+  case object::WHOLE:
+    return static_cast<object::Whole *>(obj)->name;
+  case object::ENUM:
+    return static_cast<object::Enum *>(obj)->name;
+  default:
+    return "";
+  }
+}
+
+// names only bound to numbers in entity, operators of them can't fail
+static std::set<std::string> numbers(Func *f) {
+  Entity *e = f->entity;
+  std::set<std::string> n;
+
+  for (auto &p : f->params)
+    if (p.second->kind() == T_INT || p.second->kind() == T_FLOAT)
+      n.insert(p.first);
+
+  for (auto &b : f->blocks)
+    for (auto &i : b.code)
+      if (i.co == byte::STORE &&
+          (e->types.at(i.ops.back())->kind() == T_INT ||
+           e->types.at(i.ops.back())->kind() == T_FLOAT))
+        n.insert(e->names.at(i.ops.front()));
+
+  // value is a number
+  std::function<bool(Block &, int)> number = [&](Block &b, int v) {
+    int d = defOf(b, v);
+    if (d == -1)
+      return false;
+    Ins &i = b.code.at(d);
+
+    if (i.co == byte::CONST)
+      return isNumber(e->constants.at(i.ops.front()));
+    if (i.co == byte::LOAD)
+      return n.count(e->names.at(i.ops.front())) != 0;
+    if (i.co == byte::ADD || i.co == byte::SUB || i.co == byte::MUL ||
+        i.co == byte::DIV || i.co == byte::SUR)
+      return number(b, i.args.at(0)) && number(b, i.args.at(1));
+    return false;
+  };
+
+  for (bool changed = true; changed;) {
+    changed = false;
+
+    for (auto &b : f->blocks)
+      for (auto &i : b.code) {
+        if (i.dead || !isDef(i.co) && !isBarrier(i.co) ||
+            i.co == byte::TAIL_CALL)
+          continue;
+        if (i.co == byte::USE || i.co == byte::SET || i.co == byte::GET_W ||
+            i.co == byte::PAR) {
+          changed = !n.empty();
+          n.clear(); // ANY NAME
+          continue;
+        }
+        if (i.co == byte::ITER_NEXT) {
+          for (int k : {i.ops.at(1), i.ops.at(2)})
+            if (n.erase(e->names.at(k)))
+              changed = true;
+          continue;
+        }
+
+        std::string name = isDef(i.co) ? e->names.at(i.ops.front())
+                                       : declared(e, i);
+        if (!n.count(name))
+          continue;
+
+        bool keep = i.co == byte::ASSIGN && number(b, i.args.front()) ||
+                    i.co == byte::STORE &&
+                        (e->types.at(i.ops.back())->kind() == T_INT ||
+                         e->types.at(i.ops.back())->kind() == T_FLOAT);
+        if (!keep) {
+          n.erase(name);
+          changed = true;
+        }
+      }
+  }
+  return n;
+}
+
+// loop by back jumps to its header
+struct Loop {
+  int header;                 // block of header
+  int end;                    // last position of loop
+  std::set<std::string> defs; // names bound in loop
+};
+
+// loops entered only from header and without barrier
+static std::vector<Loop> loops(Func *f) {
+  Entity *e = f->entity;
+
+  // header to last position of loop, by back jumps
+  std::map<int, int> ends;
+  for (auto &b : f->blocks) {
+    Ins &last = b.code.back();
+    if (b.reachable && last.co == byte::JUMP && last.ops.back() <= last.pc)
+      ends[last.ops.back()] = std::max(ends[last.ops.back()], last.pc);
+  }
+
+  std::vector<Loop> list;
+  for (auto &l : ends) {
+    Loop loop{-1, l.second};
+    bool ok = true;
+
+    for (int k = 0; k < f->blocks.size(); k++) {
+      Block &b = f->blocks.at(k);
+      bool inner = b.pc >= l.first && b.pc <= l.second;
+
+      if (b.pc == l.first)
+        loop.header = k;
+
+      for (auto &i : b.code) {
+        if (!inner) {
+          // ENTER LOOP NOT FROM HEADER
+          if (isJump(i.co) && i.ops.back() > l.first &&
+              i.ops.back() <= l.second)
+            ok = false;
+          continue;
+        }
+        if (i.co == byte::ITER_NEXT) {
+          loop.defs.insert(e->names.at(i.ops.at(1))); // INDEX OR KEY
+          loop.defs.insert(e->names.at(i.ops.at(2))); // ELEMENT
+          continue;
+        }
+        if (isBarrier(i.co))
+          ok = false;
+        if (isDef(i.co))
+          loop.defs.insert(e->names.at(i.ops.front()));
+      }
+    }
+    if (ok && loop.header != -1)
+      list.push_back(loop);
+  }
+  return list;
+}
+
+// the instruction of value in block, nullptr if not in
+static Ins *insOf(Block &b, int v) {
+  int d = defOf(b, v);
+  return d == -1 ? nullptr : &b.code.at(d);
+}
+
+// integer constant not less than zero, -1 if not
+static int natural(Func *f, Ins *i) {
+  if (i == nullptr || i->co != byte::CONST)
+    return -1;
+  object::Object *obj = f->entity->constants.at(i->ops.front());
+
+  if (obj->kind() != object::INT)
+    return -1;
+  return std::max(static_cast<object::Int *>(obj)->value, -1);
+}
+
+// bounds check elimination of counted loops
+//
+//   for def i: int = k; i < len(a); i += c
+//
+// with k and c not less than zero, i and a not bound by other bytecodes of
+// loop and arrays never shrink, so a[i] is in range until i is increased
+void bounds(Func *f) {
+  Entity *e = f->entity;
+
+  for (auto &l : loops(f)) {
+    if (l.header == 0)
+      continue;
+    Block &h = f->blocks.at(l.header);
+    Block &p = f->blocks.at(l.header - 1); // BEFORE LOOP
+
+    // LOAD i, LOAD len, LOAD a, CALL 1, LE, F_JUMP
+    std::vector<Ins *> cond;
+    for (auto &i : h.code)
+      if (!i.dead)
+        cond.push_back(&i);
+    if (cond.size() != 6 || cond.at(0)->co != byte::LOAD ||
+        cond.at(1)->co != byte::LOAD || cond.at(2)->co != byte::LOAD ||
+        cond.at(3)->co != byte::CALL || cond.at(3)->ops.front() != 1 ||
+        cond.at(4)->co != byte::LE || cond.at(5)->co != byte::F_JUMP ||
+        e->names.at(cond.at(1)->ops.front()) != "len")
+      continue;
+
+    int idx = cond.at(0)->ops.front();
+    std::string i = e->names.at(idx);
+    std::string a = e->names.at(cond.at(2)->ops.front());
+
+    if (i == a || l.defs.count(a))
+      continue;
+
+    // CONST k, STORE i int, and only into header
+    Ins *init = nullptr;
+    for (auto &x : p.code)
+      if (!x.dead)
+        init = &x;
+    if (init == nullptr || init->co != byte::STORE ||
+        e->names.at(init->ops.front()) != i ||
+        e->types.at(init->ops.back())->kind() != T_INT ||
+        natural(f, insOf(p, init->args.front())) == -1 ||
+        p.succs.size() != 1 || p.succs.front() != l.header)
+      continue;
+
+    bool ok = true;
+    for (auto &b : f->blocks)
+      for (auto &x : b.code)
+        if ((b.pc < h.pc || b.pc > l.end) && isJump(x.co) &&
+            x.ops.back() == h.pc)
+          ok = false; // ENTER HEADER NOT FROM BEFORE
+    if (!ok)
+      continue;
+
+    // only ASSIGN i of i + c
+    int step = -1;
+    for (auto &b : f->blocks) {
+      if (b.pc < h.pc || b.pc > l.end)
+        continue;
+
+      for (auto &x : b.code) {
+        if (x.dead || !isDef(x.co) || e->names.at(x.ops.front()) != i)
+          continue;
+
+        Ins *add = insOf(b, x.args.front());
+        if (step != -1 || x.co != byte::ASSIGN || add == nullptr ||
+            add->co != byte::ADD)
+          ok = false;
+        else {
+          Ins *y = insOf(b, add->args.at(0));
+          Ins *z = insOf(b, add->args.at(1));
+
+          if (y == nullptr || y->co != byte::LOAD || y->ops.front() != idx ||
+              natural(f, z) == -1)
+            ok = false;
+        }
+        step = x.pc;
+      }
+    }
+    if (!ok || step == -1)
+      continue;
+
+    // a[i] before increase
+    for (auto &b : f->blocks) {
+      if (b.pc < h.pc || b.pc > step)
+        continue;
+
+      for (auto &x : b.code) {
+        if (x.dead || x.pc >= step)
+          continue;
+
+        // INDEX i, LOAD a or REPLACE_L a of LOAD i
+        if (x.co == byte::INDEX) {
+          Ins *y = insOf(b, x.args.front());
+          Ins *z = insOf(b, x.args.back());
+
+          if (y != nullptr && y->co == byte::LOAD && y->ops.front() == idx &&
+              z != nullptr && z->co == byte::LOAD &&
+              e->names.at(z->ops.front()) == a)
+            x.co = byte::INDEX_U;
+        }
+        if (x.co == byte::REPLACE_L && e->names.at(x.ops.front()) == a) {
+          Ins *y = insOf(b, x.args.back());
+
+          if (y != nullptr && y->co == byte::LOAD && y->ops.front() == idx)
+            x.co = byte::REPLACE_U;
+        }
+      }
+    }
+  }
+}
+
+// loop invariant code motion
+void licm(Func *f) {
+  Entity *e = f->entity;
+  std::set<std::string> n = numbers(f);
+
+  for (auto &l : loops(f)) {
+    Block *h = &f->blocks.at(l.header);
+    std::set<std::string> &defs = l.defs;
+
+    // value can be computed before loop
+    std::function<bool(Block &, int)> invariant = [&](Block &b, int v) {
+      if (f->live.count(v))
+        return false;
+      int d = defOf(b, v);
+      if (d == -1)
+        return false;
+      Ins &i = b.code.at(d);
+
+      if (i.co == byte::CONST)
+        return isNumber(e->constants.at(i.ops.front()));
+      if (i.co == byte::LOAD) {
+        std::string name = e->names.at(i.ops.front());
+        return n.count(name) && !defs.count(name);
+      }
+      if (i.co == byte::ADD || i.co == byte::SUB || i.co == byte::MUL ||
+          i.co == byte::GR || i.co == byte::GR_E || i.co == byte::LE ||
+          i.co == byte::LE_E)
+        return invariant(b, i.args.at(0)) && invariant(b, i.args.at(1));
+      return false;
+    };
+
+    for (auto &b : f->blocks) {
+      if (b.pc < h->pc || b.pc > l.end || !b.reachable)
+        continue;
+
+      for (int k = 0; k < b.code.size(); k++) {
+        Ins &i = b.code.at(k);
+        if (i.dead || i.args.empty() || i.co == byte::CONST ||
+            i.co == byte::LOAD)
+          continue;
+        // the outermost invariant operator
+        if (invariant(b, i.def) && i.def != -1)
+          continue;
+
+        for (int a = 0; a < i.args.size(); a++) {
+          int v = i.args.at(a);
+          if (!invariant(b, v))
+            continue;
+
+          int d = defOf(b, v);
+          if (b.code.at(d).co == byte::CONST || b.code.at(d).co == byte::LOAD)
+            continue; // NOTHING TO SAVE
+
+          // copy operator and its operands to the header
+          std::vector<int> tree;
+          std::function<void(int)> collect = [&](int x) {
+            int c = defOf(b, x);
+            for (auto y : b.code.at(c).args)
+              collect(y);
+            tree.push_back(c);
+          };
+          collect(v);
+          std::sort(tree.begin(), tree.end());
+
+          for (auto c : tree)
+            h->pre.push_back(b.code.at(c));
+
+          int t = newTemp(f);
+          h->pre.push_back(Ins{byte::TEMP, {t}, {v}, -1, -1, b.code.at(d).line});
+          h->loopEnd = l.end;
+
+          kill(b, v);
+
+          // USE THE TEMPORARY
+          Ins &r = b.code.at(d);
+          r.dead = false;
+          r.co = byte::LOAD;
+          r.ops = {t};
+          r.args.clear();
+        }
+      }
+    }
+  }
+}
+
+// dead code elimination
+void dce(Func *f) {
+  for (int k = 0; k < f->blocks.size(); k++) {
+    Block &b = f->blocks.at(k);
+
+    if (!b.reachable) {
+      for (auto &i : b.code)
+        i.dead = true; // UNREACHABLE
+      continue;
+    }
+
+    // JUMP TO THE NEXT BLOCK
+    Ins &last = b.code.back();
+    if (last.co == byte::JUMP && !last.dead && k + 1 < f->blocks.size() &&
+        last.ops.back() == f->blocks.at(k + 1).pc &&
+        f->blocks.at(k + 1).pre.empty())
+      last.dead = true;
+  }
+
+  // values nobody uses, constants and temporaries
+  for (bool changed = true; changed;) {
+    changed = false;
+    std::map<int, int> n = uses(f);
+
+    for (auto &b : f->blocks)
+      for (auto &i : b.code) {
+        if (i.dead || i.def == -1 || n[i.def] != 0)
+          continue;
+        if (i.co == byte::CONST ||
+            i.co == byte::LOAD &&
+                f->entity->names.at(i.ops.front()).front() == '%') {
+          i.dead = true;
+          changed = true;
+        }
+      }
+  }
+}
+
+// bytecode reads its operands and never keeps them, except the iterated
+// object which is held by the frame
+static bool isRead(byte::Code co) {
+  return co == byte::INDEX || co == byte::INDEX_U || co == byte::GET ||
+         co == byte::ITER_INIT || co == byte::E_E || co == byte::N_E ||
+         isArith(co);
+}
+
+// value of block is only read by bytecodes of it
+static bool local(Func *f, Block &b, int v) {
+  if (f->live.count(v))
+    return false; // ACROSS BLOCKS
+  for (auto &i : b.code)
+    if (!i.dead && std::count(i.args.begin(), i.args.end(), v) &&
+        !isRead(i.co))
+      return false;
+  return true;
+}
+
+// allocations not escaping the frame
+//
+// arrays, tuples, maps and concatenated strings only read in their block
+// are placed in the scratch of frame, which is freed as the function
+// returns, names are looked up by callees so bound ones are escaped
+void escape(Func *f) {
+  if (!f->returns)
+    return;
+  Entity *e = f->entity;
+
+  for (auto &b : f->blocks) {
+    std::set<int> strs; // VALUES OF STRING
+    std::vector<Ins> code;
+
+    for (auto &i : b.code) {
+      if (i.dead) {
+        code.push_back(i);
+        continue;
+      }
+      if (i.co == byte::CONST &&
+          e->constants.at(i.ops.front())->kind() == object::STR)
+        strs.insert(i.def);
+
+      bool alloc = i.co == byte::B_ARR || i.co == byte::B_TUP ||
+                   i.co == byte::B_MAP;
+      if (i.co == byte::ADD &&
+          (strs.count(i.args.front()) || strs.count(i.args.back()))) {
+        strs.insert(i.def);
+        alloc = true;
+      }
+
+      if (alloc && local(f, b, i.def)) {
+        Ins l;
+        l.co = byte::LOCAL;
+        l.line = i.line;
+        code.push_back(l);
+      }
+      code.push_back(i);
+    }
+    b.code = code;
+  }
+}
+
+// write blocks back to bytecodes of entity
+void lower(Func *f) {
+  Entity *e = f->entity;
+  Entity t(e->title);
+
+  std::map<int, int> at;    // block to new position
+  std::map<int, int> inner; // block to new position after hoisted bytecodes
+  std::map<int, int> pcs;   // old position to new
+
+  std::vector<std::tuple<int, int, int>> jumps; // operand, offset, from
+
+  auto emit = [&](Ins &i) {
+    if (i.pc != -1)
+      pcs[i.pc] = t.codes.size();
+    t.emitCode(i.co, i.line);
+
+    for (int k = 0; k < i.ops.size(); k++) {
+      if (isJump(i.co) && k == i.ops.size() - 1)
+        jumps.push_back(std::make_tuple(t.emitJump(0), i.ops.at(k), i.pc));
+      else
+        t.emitOperand(i.ops.at(k));
+    }
+  };
+
+  for (auto &b : f->blocks) {
+    at[b.pc] = t.codes.size();
+    for (auto &i : b.pre)
+      emit(i);
+    inner[b.pc] = t.codes.size();
+
+    for (auto &i : b.code)
+      if (!i.dead)
+        emit(i);
+  }
+  at[e->codes.size()] = inner[e->codes.size()] = t.codes.size(); // END
+
+  for (auto &j : jumps) {
+    int to = std::get<1>(j);
+    int from = std::get<2>(j);
+
+    if (at.count(to)) {
+      // in loop to its header, skip the hoisted bytecodes
+      bool in = false;
+      for (auto &b : f->blocks)
+        if (b.pc == to && b.loopEnd != -1 && from >= to && from <= b.loopEnd)
+          in = true;
+      to = in ? inner.at(to) : at.at(to);
+    }
+    t.patchJump(std::get<0>(j), to);
+    t.jumpOffsets.push_back(to);
+  }
+
+  std::vector<std::pair<int, std::string>> inlined;
+  for (auto &i : e->inlined)
+    if (pcs.count(i.first))
+      inlined.push_back(std::make_pair(pcs.at(i.first), i.second));
+
+  e->codes = t.codes;
+  e->lineno = t.lineno;
+  e->jumpOffsets = t.jumpOffsets;
+  e->inlined = inlined;
+}
+
+// output instruction
+static void dumpIns(Func *f, Ins &i, std::map<int, int> &blocks) {
+  Entity *e = f->entity;
+  std::stringstream str;
+
+  if (i.def != -1)
+    str << "%" << i.def << " = ";
+  str << byte::codeString[i.co];
+
+  switch (i.co) {
+  case byte::CONST:
+  case byte::FUNC:
+  case byte::WHOLE:
+  case byte::ENUM:
+    str << " " << e->constants.at(i.ops.front())->rawStringer();
+    break;
+  case byte::STORE:
+    str << " '" << e->names.at(i.ops.front()) << "' "
+        << e->types.at(i.ops.back())->stringer();
+    break;
+  case byte::NEW:
+    str << " '" << e->names.at(i.ops.front()) << "' " << i.ops.back();
+    break;
+  case byte::PAR:
+    str << " " << e->constants.at(i.ops.at(0))->rawStringer() << " '"
+        << e->names.at(i.ops.at(1)) << "' '" << e->names.at(i.ops.at(2)) << "'";
+    break;
+  case byte::ITER_NEXT:
+    str << " " << i.ops.at(0) << " '" << e->names.at(i.ops.at(1)) << "' '"
+        << e->names.at(i.ops.at(2)) << "'"; // AND ITS JUMP
+  case byte::JUMP:
+  case byte::F_JUMP:
+  case byte::T_JUMP:
+    if (blocks.count(i.ops.back()))
+      str << " B" << blocks.at(i.ops.back());
+    else
+      str << " " << i.ops.back();
+    break;
+  default:
+    if (byte::codeOperands[i.co] == 1 &&
+        (i.co == byte::CALL || i.co == byte::TAIL_CALL ||
+         i.co == byte::B_ARR || i.co == byte::B_TUP || i.co == byte::B_MAP ||
+         i.co == byte::SLICE || i.co == byte::ITER_INIT))
+      str << " " << i.ops.front();
+    else if (byte::codeOperands[i.co] == 1)
+      str << " '" << e->names.at(i.ops.front()) << "'";
+  }
+
+  for (int k = 0; k < i.args.size(); k++)
+    str << (k == 0 ? " " : ", ") << "%" << i.args.at(k);
+
+  std::cout << "    " << str.str() << std::endl;
+}
+
+// output blocks after pass
+void dump(Func *f, std::string pass) {
+  std::map<int, int> blocks; // position to block
+  for (int k = 0; k < f->blocks.size(); k++)
+    blocks[f->blocks.at(k).pc] = k;
+
+  std::cout << "IR '" << f->entity->title << "' AFTER " << pass << ": "
+            << std::endl;
+
+  for (int k = 0; k < f->blocks.size(); k++) {
+    Block &b = f->blocks.at(k);
+    if (!b.reachable && pass != "lift")
+      continue;
+
+    std::cout << "  B" << k;
+    for (int p = 0; p < b.params.size(); p++)
+      std::cout << (p == 0 ? "(" : ", ") << "%" << b.params.at(p)
+                << (p == b.params.size() - 1 ? ")" : "");
+    std::cout << ":";
+    for (auto s : b.succs)
+      std::cout << " -> B" << s;
+    std::cout << std::endl;
+
+    if (!b.pre.empty()) {
+      std::cout << "   PRE:" << std::endl;
+      for (auto &i : b.pre)
+        dumpIns(f, i, blocks);
+      std::cout << "   LOOP:" << std::endl;
+    }
+    for (auto &i : b.code)
+      if (!i.dead)
+        dumpIns(f, i, blocks);
+  }
+}
+
+// passes in order
+static std::vector<std::pair<std::string, void (*)(Func *)>> passes = {
+    {"constant", constant}, {"copy", copy}, {"constant", constant},
+    {"cse", cse},           {"bounds", bounds},
+    {"licm", licm},         {"dce", dce},           {"escape", escape},
+};
+
+// run passes on entity and its functions
+static void run(Entity *e, std::map<std::string, Type *> params, bool fn,
+                bool out) {
+  for (auto i : e->constants) {
+    if (i->kind() == object::FUNC &&
+        static_cast<object::Func *>(i)->entity != nullptr) {
+      object::Func *fn = static_cast<object::Func *>(i);
+
+      std::map<std::string, Type *> p;
+      for (auto &a : fn->arguments)
+        p[a.first->literal] = a.second;
+      run(fn->entity, p, true, out); // FUNCTION
+    }
+    if (i->kind() == object::WHOLE &&
+        static_cast<object::Whole *>(i)->entity != nullptr)
+      run(static_cast<object::Whole *>(i)->entity, {}, false, out); // WHOLE
+  }
+
+  Func *f = lift(e, params);
+  if (f == nullptr)
+    return; // AS IT IS
+  f->returns = fn;
+
+  if (out)
+    dump(f, "lift");
+
+  for (auto &p : passes) {
+    p.second(f);
+    if (out)
+      dump(f, p.first);
+  }
+
+  lower(f);
+  delete f;
+}
+
+// run passes on entity and the entities of its functions
+void optimize(Entity *e, bool out) { run(e, {}, false, out); }
+}; // namespace ir
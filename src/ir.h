@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_IR_H
+#define DRIFT_IR_H
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "entity.h"
+#include "object.h"
+#include "opcode.h"
+#include "type.h"
+
+// mid-level representation of entity between compiler and vm
+//
+// bytecodes are split into basic blocks, every value pushed to stack is
+// defined once as %n and used by the bytecode pops it, values on stack at
+// the entry of block are its parameters
+namespace ir {
+
+// bytecode with its stack operands
+struct Ins {
+  byte::Code co;         // bytecode
+  std::vector<int> ops;  // operands of bytecode
+  std::vector<int> args; // values used, from bottom to top of stack
+  int def = -1;          // value defined
+  int pc = -1;           // position in original bytecodes, -1 if new
+  int line = 0;          // line no
+  bool dead = false;     // removed
+};
+
+// basic block
+struct Block {
+  int pc;                  // position of first bytecode
+  std::vector<int> params; // values on stack at entry
+  std::vector<Ins> code;   // bytecodes
+  std::vector<int> outs;   // values on stack at exit
+  std::vector<int> succs;  // successor blocks
+
+  std::vector<Ins> pre; // hoisted bytecodes run before entering the loop
+  int loopEnd = -1;     // last position of loop if it is a loop header
+
+  bool reachable = false;
+};
+
+// entity in blocks
+struct Func {
+  Entity *entity;
+  std::vector<Block> blocks;
+
+  int values = 0; // count of values
+  int temps = 0;  // count of temporary names
+
+  std::map<std::string, Type *> params; // parameters of function
+  std::set<int> live;                   // values across blocks
+
+  bool returns = false; // entity of function, its frame is dropped at return
+};
+
+// split entity into blocks, nullptr if the stack is not balanced
+Func *lift(Entity *, std::map<std::string, Type *>);
+
+// write blocks back to bytecodes of entity
+void lower(Func *);
+
+// output blocks after pass
+void dump(Func *, std::string);
+
+void constant(Func *); // constant propagation and folding
+void copy(Func *);     // copy propagation of names
+void cse(Func *);      // common subexpression elimination
+void bounds(Func *);   // bounds check elimination of counted loops
+void licm(Func *);     // loop invariant code motion
+void dce(Func *);      // dead code elimination
+void escape(Func *);   // allocations not escaping the frame
+
+// run passes on entity and the entities of its functions
+void optimize(Entity *, bool);
+}; // namespace ir
+
+#endif
@@ -15,11 +15,18 @@
 #ifndef DRIFT_OBJECT_H
 #define DRIFT_OBJECT_H
 
+#include <deque>
+#include <memory>
+#include <mutex>
+
 #include "ast.h"
+#include "gc.h"
+#include "slab.h"
 #include "type.h"
 
 struct Entity;
 struct Frame;
+struct Task;
 
 // object
 namespace object {
@@ -37,7 +44,9 @@ enum Kind {
   FUNC,
   WHOLE,
   MODULE,
-  MODS
+  MODS,
+  GEN,
+  CHAN
 };
 
 // object abstract
@@ -49,6 +58,28 @@ public:
   virtual std::string rawStringer() = 0;
   // return the kind of object
   virtual Kind kind() = 0;
+
+  // of collector, not copied with object
+  gc::Color color = gc::fresh();
+  bool old = gc::tenure(); // promoted out of nursery
+  bool remembered = false; // old one written since last minor collection
+  bool local = false;      // in scratch of frame, not collected
+  bool arena = gc::arena(); // made by a parallel loop
+  bool permanent = gc::permanent(); // made out of runtime, shared by tasks
+
+  Object() {}
+  Object(const Object &) {}
+  Object &operator=(const Object &) { return *this; }
+
+  virtual ~Object() {}
+
+  // objects are allocated from slabs of their size and collected
+  static void *operator new(std::size_t n) {
+    void *p = slab::alloc(n);
+    gc::track(static_cast<Object *>(p));
+    return p;
+  }
+  static void operator delete(void *p, std::size_t n) { slab::free(p, n); }
 };
 
 // INT
@@ -123,7 +154,9 @@ public:
     return str.str();
   }
 
-  std::string stringer() override { return std::string(&value); }
+  std::string stringer() override {
+    return value == 0 ? "" : std::string(1, value);
+  }
 
   Kind kind() override { return CHAR; }
 };
@@ -144,18 +177,231 @@ public:
   Kind kind() override { return BOOL; }
 };
 
+inline void hold(Object *);    // held by a name or element
+inline void release(Object *); // no longer held by a name or element
+inline bool owned(Object *);   // written in place by current heap
+
+// storage of array elements
+enum Packed {
+  P_OBJ,   // objects
+  P_INT,   // contiguous int
+  P_FLOAT, // contiguous float
+  P_CHAR,  // contiguous char
+};
+
 // ARRAY
 class Array : public Object {
 public:
-  std::vector<object::Object *> elements;
+  std::vector<object::Object *> elements; // P_OBJ
+
+  Packed packed = P_OBJ; // storage of elements
+
+  std::vector<int> ints;      // P_INT
+  std::vector<double> floats; // P_FLOAT
+  std::string chars;          // P_CHAR
+
+  int refs = 0; // names and elements holding it, copied on write if shared
+
+  Array *view = nullptr; // array whose storage is shared, if it is a slice
+  int from = 0;          // first element of view
+  int count = 0;         // number of elements of view
+
+  // slice of elements sharing the storage, lo and hi are in range
+  Array *slice(int lo, int hi) {
+    if (view != nullptr)
+      return view->slice(from + lo, from + hi);
+    Array *a = new Array;
+
+    a->view = this;
+    a->from = lo;
+    a->count = hi - lo;
+    hold(this); // COPIED ON WRITE
+    return a;
+  }
+
+  // storage of elements, the one of array viewed
+  Packed storage() { return view != nullptr ? view->packed : packed; }
+
+  // copy elements of view into own storage
+  void flat() {
+    if (view == nullptr)
+      return;
+    packed = view->packed;
+
+    switch (packed) {
+    case P_INT:
+      ints.assign(view->ints.begin() + from,
+                  view->ints.begin() + from + count);
+      break;
+    case P_FLOAT:
+      floats.assign(view->floats.begin() + from,
+                    view->floats.begin() + from + count);
+      break;
+    case P_CHAR:
+      chars = view->chars.substr(from, count);
+      break;
+    default:
+      elements.assign(view->elements.begin() + from,
+                      view->elements.begin() + from + count);
+      for (auto i : elements)
+        hold(i);
+      break;
+    }
+    release(view);
+    view = nullptr;
+  }
+
+  // copy of elements, to be written instead of the shared one
+  Array *clone() {
+    if (view != nullptr)
+      return view->slice(from, from + count);
+    Array *a = new Array;
+
+    a->elements = elements;
+    a->packed = packed;
+    a->ints = ints;
+    a->floats = floats;
+    a->chars = chars;
+
+    for (auto i : elements)
+      hold(i);
+    return a;
+  }
+
+  // number of elements
+  int size() {
+    if (view != nullptr)
+      return count;
+    switch (packed) {
+    case P_INT:
+      return ints.size();
+    case P_FLOAT:
+      return floats.size();
+    case P_CHAR:
+      return chars.size();
+    default:
+      return elements.size();
+    }
+  }
+
+  // element at index, boxed if it is packed
+  object::Object *at(int i) {
+    if (view != nullptr)
+      return view->at(from + i);
+    switch (packed) {
+    case P_INT:
+      return new Int(ints[i]);
+    case P_FLOAT:
+      return new Float(floats[i]);
+    case P_CHAR:
+      return new Char(chars[i]);
+    default:
+      return elements[i];
+    }
+  }
+
+  // replace element at index, unpack if its kind is not the storage
+  void set(int i, object::Object *obj) {
+    flat();
+    if (packed == P_INT && obj->kind() == INT)
+      ints[i] = static_cast<Int *>(obj)->value;
+    else if (packed == P_FLOAT && obj->kind() == FLOAT)
+      floats[i] = static_cast<Float *>(obj)->value;
+    else if (packed == P_CHAR && obj->kind() == CHAR)
+      chars[i] = static_cast<Char *>(obj)->value;
+    else {
+      unpack();
+      elements[i] = obj;
+    }
+  }
+
+  // move elements into storage of element type, if all of them are of it
+  void pack(Type *T) {
+    Kind k;
+    switch (T->kind()) {
+    case T_INT:
+      k = INT;
+      break;
+    case T_FLOAT:
+      k = FLOAT;
+      break;
+    case T_CHAR:
+      k = CHAR;
+      break;
+    default:
+      return;
+    }
+    if (storage() == (k == INT ? P_INT : k == FLOAT ? P_FLOAT : P_CHAR))
+      return; // PACKED OR A VIEW OF IT
+    flat();
+    if (packed != P_OBJ)
+      return;
+    for (auto i : elements)
+      if (i->kind() != k)
+        return;
+
+    for (auto i : elements) {
+      if (k == INT)
+        ints.push_back(static_cast<Int *>(i)->value);
+      if (k == FLOAT)
+        floats.push_back(static_cast<Float *>(i)->value);
+      if (k == CHAR)
+        chars.push_back(static_cast<Char *>(i)->value);
+    }
+    packed = k == INT ? P_INT : k == FLOAT ? P_FLOAT : P_CHAR;
+    std::vector<object::Object *>().swap(elements); // RELEASE
+  }
+
+  // box elements back into objects
+  void unpack() {
+    flat();
+    if (packed == P_OBJ)
+      return;
+    for (int i = 0; i < size(); i++)
+      elements.push_back(at(i));
+
+    packed = P_OBJ;
+    std::vector<int>().swap(ints);
+    std::vector<double>().swap(floats);
+    std::string().swap(chars);
+  }
+
+  // grow to n elements of zero value, only if it is packed
+  void grow(int n) {
+    if (n <= size())
+      return;
+    flat();
+    if (packed == P_INT)
+      ints.resize(n);
+    if (packed == P_FLOAT)
+      floats.resize(n);
+    if (packed == P_CHAR)
+      chars.resize(n);
+  }
+
+  // string of element at index
+  std::string element(int i) {
+    if (view != nullptr)
+      return view->element(from + i);
+    switch (packed) {
+    case P_INT:
+      return std::to_string(ints[i]);
+    case P_FLOAT:
+      return std::to_string(floats[i]);
+    case P_CHAR:
+      return std::string(1, chars[i]);
+    default:
+      return elements[i]->stringer();
+    }
+  }
 
   std::string rawStringer() override {
     std::stringstream str;
 
     str << "<Array [";
-    for (auto iter = elements.begin(); iter != elements.end();) {
-      str << (*iter)->stringer();
-      if (++iter != elements.end()) {
+    for (int i = 0; i < size(); i++) {
+      str << element(i);
+      if (i + 1 != size()) {
         str << ", ";
       }
     }
@@ -168,9 +414,9 @@ public:
     std::stringstream str;
 
     str << "[";
-    for (auto iter = elements.begin(); iter != elements.end();) {
-      str << (*iter)->stringer();
-      if (++iter != elements.end()) {
+    for (int i = 0; i < size(); i++) {
+      str << element(i);
+      if (i + 1 != size()) {
         str << ", ";
       }
     }
@@ -225,6 +471,20 @@ class Map : public Object {
 public:
   std::map<object::Object *, object::Object *> elements;
 
+  int refs = 0; // names and elements holding it, copied on write if shared
+
+  // copy of elements, to be written instead of the shared one
+  Map *clone() {
+    Map *m = new Map;
+
+    m->elements = elements;
+    for (auto &i : elements) {
+      hold(i.first);
+      hold(i.second);
+    }
+    return m;
+  }
+
   std::string rawStringer() override {
     std::stringstream str;
 
@@ -259,6 +519,43 @@ public:
   Kind kind() override { return MAP; }
 };
 
+// written in place by current heap, objects out of an arena are read only
+// to the parallel loop as other threads read them
+inline bool owned(Object *o) { return o->arena || !gc::arena(); }
+
+// held by a name or element
+inline void hold(Object *o) {
+  if (o == nullptr || !owned(o))
+    return;
+  gc::barrier(o); // SHADE WHILE MARKING
+  if (o->kind() == ARRAY)
+    static_cast<Array *>(o)->refs++;
+  if (o->kind() == MAP)
+    static_cast<Map *>(o)->refs++;
+}
+
+// no longer held by a name or element
+inline void release(Object *o) {
+  if (o == nullptr || !owned(o))
+    return;
+  if (o->kind() == ARRAY)
+    static_cast<Array *>(o)->refs--;
+  if (o->kind() == MAP)
+    static_cast<Map *>(o)->refs--;
+}
+
+// array or map held by more than one, strings and tuples are never
+// written in place so they are shared as they are
+inline bool shared(Object *o) {
+  if (!owned(o))
+    return true; // OF MAIN HEAP, IN PARALLEL LOOP
+  if (o->kind() == ARRAY)
+    return static_cast<Array *>(o)->refs > 1;
+  if (o->kind() == MAP)
+    return static_cast<Map *>(o)->refs > 1;
+  return false;
+}
+
 // ENUM
 class Enum : public Object {
 public:
@@ -279,9 +576,9 @@ public:
   ast::FuncArg arguments; // function args
   Type *ret;              // function return
 
-  Entity *entity; // function entity
+  Entity *entity = nullptr; // function entity
 
-  std::vector<object::Object *> builtin; // for builtin function arguments
+  bool gen = false; // has yield, calling it makes a generator
 
   std::string rawStringer() override { return "<Func '" + name + "'>"; }
   std::string stringer() override { return "<Func '" + name + "'>"; }
@@ -289,12 +586,57 @@ public:
   Kind kind() override { return FUNC; }
 };
 
+// GEN
+class Gen : public Object {
+public:
+  Func *func;   // generator function
+  Frame *frame; // suspended frame, nullptr if returned
+
+  explicit Gen(Func *f, Frame *fra) : func(f), frame(fra) {}
+
+  std::string rawStringer() override { return "<Gen '" + func->name + "'>"; }
+  std::string stringer() override { return "<Gen '" + func->name + "'>"; }
+
+  Kind kind() override { return GEN; }
+};
+
+// CHAN, an object of each task holding it, they share the queue
+//
+// a value sent is copied into a heap of its own, the heap is handed to the
+// receiver as it is, so that tasks on other threads never share objects
+class Chan : public Object {
+public:
+  struct Queue {
+    std::mutex m; // OF ALL BELOW, THE SENDERS ARE ON OTHER THREADS
+
+    // values sent and not received, each one in its heap
+    std::deque<std::pair<std::unique_ptr<gc::Heap>, Object *>> buffer;
+    int cap; // most values of buffer
+
+    std::deque<Task *> senders;   // blocked as buffer is full
+    std::deque<Task *> receivers; // blocked as buffer is empty
+  };
+  std::shared_ptr<Queue> q;
+
+  explicit Chan(int cap) : q(new Queue) { q->cap = cap; }
+  explicit Chan(std::shared_ptr<Queue> q) : q(q) {}
+
+  std::string rawStringer() override {
+    std::lock_guard<std::mutex> l(q->m);
+    return "<Chan " + std::to_string(q->buffer.size()) + "/" +
+           std::to_string(q->cap) + ">";
+  }
+  std::string stringer() override { return rawStringer(); }
+
+  Kind kind() override { return CHAN; }
+};
+
 // WHOLE
 class Whole : public Object {
 public:
   std::string name; // whole name
 
-  Entity *entity; // whole entity
+  Entity *entity = nullptr; // whole entity
 
   // interface definition
   std::vector<std::tuple<std::string, ast::FaceArg, Type *>> interface;
@@ -302,7 +644,7 @@ public:
   std::vector<std::string> inherit;
 
   // whole fram
-  Frame *f;
+  Frame *f = nullptr;
 
   bool newOut = false; // is new out?
 
@@ -20,7 +20,7 @@
 // bytecode
 namespace byte {
 // total number of bytecodes
-constexpr int len = 41;
+constexpr int len = 60;
 // bytecode type
 enum Code {
   CONST,   // CONST
@@ -73,16 +73,49 @@ enum Code {
 
   RET_N, // RET_N
   RET,
+
+  TAIL_CALL, // TAIL_CALL
+  TEMP,      // TEMP
+  INDEX_U,   // INDEX WITHOUT CHECK
+  REPLACE_L, // REPLACE OF NAME
+  REPLACE_U, // REPLACE OF NAME WITHOUT CHECK
+  SLICE,     // SLICE
+  ITER_INIT, // ITERATOR OF LOOP
+  ITER_NEXT, // NEXT ELEMENT OF ITERATOR
+  YIELD,     // YIELD OF GENERATOR
+  LOCAL,     // NEXT ALLOCATION IN SCRATCH OF FRAME
+  PAR,       // PARALLEL LOOP
+  INDEX_L,   // INDEX OF NAME TO BE WRITTEN
+  INDEX_W,   // INDEX TO BE WRITTEN
+  GET_W,     // GET TO BE WRITTEN
+
+  // THREE ADDRESS
+  R_ASSIGN, // NAME = X <OP> Y
+  R_PUSH,   // X <OP> Y
+  R_F_JUMP, // F_JUMP X <OP> Y
+  R_T_JUMP, // T_JUMP X <OP> Y
+  R_MOVE,   // NAME = X
 };
 
 // return a string of bytecode
 static std::string codeString[len] = {
-    "CONST", "ASSIGN", "STORE",  "LOAD",   "INDEX", "REPLACE", "GET",
-    "SET",   "CALL",   "ORIG",   "NAME",   "NEW",   "DEL",     "FUNC",
-    "WHOLE", "ENUM",   "MOD",    "USE",    "B_ARR", "B_TUP",   "B_MAP",
-    "ADD",   "SUB",    "MUL",    "DIV",    "SUR",   "GR",      "LE",
-    "GR_E",  "LE_E",   "E_E",    "N_E",    "AND",   "OR",      "BANG",
-    "NOT",   "JUMP",   "F_JUMP", "T_JUMP", "RET_N", "RET",
+    "CONST",     "ASSIGN",   "STORE",    "LOAD",      "INDEX",   "REPLACE",
+    "GET",       "SET",      "CALL",     "ORIG",      "NAME",    "NEW",
+    "DEL",       "FUNC",     "WHOLE",    "ENUM",      "MOD",     "USE",
+    "B_ARR",     "B_TUP",    "B_MAP",    "ADD",       "SUB",     "MUL",
+    "DIV",       "SUR",      "GR",       "LE",        "GR_E",    "LE_E",
+    "E_E",       "N_E",      "AND",      "OR",        "BANG",    "NOT",
+    "JUMP",      "F_JUMP",   "T_JUMP",   "RET_N",     "RET",     "TAIL_CALL",
+    "TEMP",      "INDEX_U",  "REPLACE_L", "REPLACE_U", "SLICE",    "ITER_INIT",
+    "ITER_NEXT", "YIELD",    "LOCAL",     "PAR",       "INDEX_L",  "INDEX_W",
+    "GET_W",     "R_ASSIGN", "R_PUSH",    "R_F_JUMP",  "R_T_JUMP", "R_MOVE",
+};
+
+// number of operands of bytecode
+static int codeOperands[len] = {
+    1, 1, 2, 1, 0, 0, 1, 1, 1, 0, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1, 1, 4, 0,
+    0, 3, 1, 0, 1, 4, 3, 4, 4, 2,
 };
 }; // namespace byte
 
@@ -236,8 +236,17 @@ ast::Expr *Parser::call() {
       // empty index
       if (look(token::R_BRACKET))
         error(exp::UNEXPECTED, "null index");
-      // index
-      auto index = this->expr();
+      // index, or nothing of slice from the first
+      ast::Expr *index = look().kind == token::COLON ? nullptr : this->expr();
+      // slice
+      if (look(token::COLON)) {
+        ast::Expr *hi = look().kind == token::R_BRACKET ? nullptr : this->expr();
+
+        if (!look(token::R_BRACKET))
+          error(exp::UNEXPECTED, "expect ']' after slice");
+        expr = new ast::SliceExpr(expr, index, hi);
+        continue;
+      }
 
       if (!look(token::R_BRACKET))
         error(exp::UNEXPECTED, "expect ']' after index of array");
@@ -548,7 +557,28 @@ ast::Stmt *Parser::stmt() {
     // for loop
   case token::FOR: {
     this->position++;
-    
+
+    // for <name> in | for <name>, <name> in
+    if (look().kind == token::IDENT &&
+        (look(1).kind == token::IDENT && look(1).literal == "in" ||
+         look(1).kind == token::COMMA && look(2).kind == token::IDENT &&
+             look(3).kind == token::IDENT && look(3).literal == "in")) {
+      std::vector<token::Token> names = {look()};
+      this->position++;
+
+      if (look(token::COMMA)) {
+        names.push_back(look());
+        this->position++;
+
+        if (names.front().literal == names.back().literal)
+          error(exp::UNEXPECTED, "same names of index and element");
+      }
+      this->position++; // skip in
+
+      ast::Expr *expr = this->expr();
+      return new ast::ForInStmt(names, expr, this->block(token::END));
+    }
+
     ast::Stmt *init = this->stmt(); // initializer
     if (!look(token::SEMICOLON))
       error(exp::UNEXPECTED, "expect ';' after expression");
@@ -610,6 +640,11 @@ ast::Stmt *Parser::stmt() {
     }
     return new ast::UseStmt(previous());
   } break;
+    // yield of generator
+    // yield <expr>
+  case token::YIELD:
+    this->position++;
+    return new ast::YieldStmt(this->expr());
     // return
     // ret <expr>
     // ret ->
@@ -653,6 +688,45 @@ ast::Stmt *Parser::stmt() {
   } break;
   //
   default:
+    // par <name> in | par <name>, <name> in
+    if (look().kind == token::IDENT && look().literal == "par" &&
+        look(1).kind == token::IDENT &&
+        (look(2).kind == token::IDENT && look(2).literal == "in" ||
+         look(2).kind == token::COMMA && look(3).kind == token::IDENT &&
+             look(4).kind == token::IDENT && look(4).literal == "in")) {
+      this->position++;
+
+      std::vector<token::Token> names = {look()};
+      this->position++;
+
+      if (look(token::COMMA)) {
+        names.push_back(look());
+        this->position++;
+
+        if (names.front().literal == names.back().literal)
+          error(exp::UNEXPECTED, "same names of index and element");
+      }
+      this->position++; // skip in
+
+      ast::Expr *expr = this->expr();
+
+      // -> + <name>, < <name>, > <name>
+      std::vector<std::pair<token::Token, token::Token>> reduce;
+      if (look(token::R_ARROW))
+        do {
+          token::Token op = look();
+          if (op.kind != token::ADD && op.kind != token::LESS &&
+              op.kind != token::GREATER)
+            error(exp::UNEXPECTED, "reduction operator must be +, < or >");
+          this->position++;
+
+          if (!look(token::IDENT))
+            error(exp::UNEXPECTED, "reduction name must be an identifier");
+          reduce.push_back(std::make_pair(op, previous()));
+        } while (look(token::COMMA));
+
+      return new ast::ParStmt(names, expr, reduce, this->block(token::END));
+    }
     // expression statement
     return new ast::ExprStmt(this->expr());
   }
@@ -718,6 +792,12 @@ Type *Parser::type(bool previous) {
     // T5
     if (now.literal == S_BOOL)
       return new Bool;
+    // T6
+    if (now.literal == S_GEN)
+      return new Gen;
+    // T7
+    if (now.literal == S_CHAN)
+      return new Chan;
     // user define type
     return new User(now);
   }
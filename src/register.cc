@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#include "register.h"
+
+// decoded bytecode
+struct Ins {
+  int pc;               // position in stream
+  byte::Code co;        // bytecode
+  std::vector<int> ops; // operands
+  int line;             // line no
+};
+
+// bytecode of jump, its last operand is the offset
+static bool isJump(byte::Code co) {
+  return co == byte::JUMP || co == byte::F_JUMP || co == byte::T_JUMP ||
+         co == byte::R_F_JUMP || co == byte::R_T_JUMP ||
+         co == byte::ITER_NEXT;
+}
+
+// comparison of numbers
+static bool isCompare(byte::Code co) {
+  return co == byte::GR || co == byte::GR_E || co == byte::LE ||
+         co == byte::LE_E;
+}
+
+// arithmetic and comparison of numbers
+static bool isArith(byte::Code co) {
+  return co == byte::ADD || co == byte::SUB || co == byte::MUL ||
+         co == byte::DIV || co == byte::SUR || isCompare(co);
+}
+
+// operand of a name or a constant which is not string template
+static bool isOperand(Entity *e, Ins &i, int *v) {
+  if (i.co == byte::LOAD) {
+    *v = i.ops.front() << 1; // NAME
+    return true;
+  }
+  if (i.co == byte::CONST &&
+      e->constants.at(i.ops.front())->kind() != object::STR) {
+    *v = i.ops.front() << 1 | 1; // CONST
+    return true;
+  }
+  return false;
+}
+
+// translate stack bytecodes of entity and its functions to three address
+void registers(Entity *e) {
+  for (auto i : e->constants) {
+    if (i->kind() == object::FUNC &&
+        static_cast<object::Func *>(i)->entity != nullptr)
+      registers(static_cast<object::Func *>(i)->entity); // FUNCTION
+    if (i->kind() == object::WHOLE &&
+        static_cast<object::Whole *>(i)->entity != nullptr)
+      registers(static_cast<object::Whole *>(i)->entity); // WHOLE
+  }
+
+  std::vector<Ins> list; // DECODE
+  std::set<int> targets; // positions of jump to
+
+  for (int ip = 0; ip < e->codes.size();) {
+    Ins i;
+    i.pc = ip;
+    i.co = (byte::Code)e->codes.at(ip++);
+    i.line = e->line(i.pc);
+
+    for (int k = 0; k < byte::codeOperands[i.co]; k++)
+      i.ops.push_back(e->operand(ip));
+    if (isJump(i.co))
+      targets.insert(i.ops.back());
+
+    list.push_back(i);
+  }
+
+  // no jump into the middle of n bytecodes from position
+  auto single = [&](int from, int n) {
+    if (from + n > list.size())
+      return false;
+    for (int k = 1; k < n; k++)
+      if (targets.count(list.at(from + k).pc))
+        return false;
+    return true;
+  };
+
+  Entity t(e->title);
+
+  std::map<int, int> at;                  // old position to new
+  std::vector<std::pair<int, int>> jumps; // new operand and old offset
+
+  for (int i = 0; i < list.size();) {
+    Ins &a = list.at(i);
+    at[a.pc] = t.codes.size();
+
+    int x, y;
+    // X <OP> Y
+    if (single(i, 3) && isOperand(e, a, &x) &&
+        isOperand(e, list.at(i + 1), &y) && isArith(list.at(i + 2).co)) {
+      byte::Code op = list.at(i + 2).co;
+
+      if (single(i, 4) && list.at(i + 3).co == byte::ASSIGN) {
+        t.emitCode(byte::R_ASSIGN, a.line);
+        t.emitOperand(op);
+        t.emitOperand(list.at(i + 3).ops.front()); // NAME
+        t.emitOperand(x);
+        t.emitOperand(y);
+        i += 4;
+        continue;
+      }
+      if (single(i, 4) && isCompare(op) &&
+          (list.at(i + 3).co == byte::F_JUMP ||
+           list.at(i + 3).co == byte::T_JUMP)) {
+        t.emitCode(list.at(i + 3).co == byte::F_JUMP ? byte::R_F_JUMP
+                                                     : byte::R_T_JUMP,
+                   a.line);
+        t.emitOperand(op);
+        t.emitOperand(x);
+        t.emitOperand(y);
+        jumps.push_back(
+            std::make_pair(t.emitJump(0), list.at(i + 3).ops.front()));
+        i += 4;
+        continue;
+      }
+      t.emitCode(byte::R_PUSH, a.line);
+      t.emitOperand(op);
+      t.emitOperand(x);
+      t.emitOperand(y);
+      i += 3;
+      continue;
+    }
+    // NAME = X
+    if (single(i, 2) && isOperand(e, a, &x) &&
+        list.at(i + 1).co == byte::ASSIGN) {
+      t.emitCode(byte::R_MOVE, a.line);
+      t.emitOperand(list.at(i + 1).ops.front()); // NAME
+      t.emitOperand(x);
+      i += 2;
+      continue;
+    }
+
+    // AS IT IS
+    t.emitCode(a.co, a.line);
+    for (int k = 0; k < a.ops.size(); k++) {
+      if (isJump(a.co) && k == a.ops.size() - 1)
+        jumps.push_back(std::make_pair(t.emitJump(0), a.ops.at(k)));
+      else
+        t.emitOperand(a.ops.at(k));
+    }
+    i++;
+  }
+  at[e->codes.size()] = t.codes.size(); // END
+
+  for (auto &j : jumps) {
+    auto iter = at.find(j.second);
+    // out of entity is not changed
+    int to = iter == at.end() ? j.second : iter->second;
+
+    t.patchJump(j.first, to);
+    t.jumpOffsets.push_back(to);
+  }
+  for (auto &i : e->inlined)
+    if (at.count(i.first))
+      i.first = at.at(i.first);
+
+  e->codes = t.codes;
+  e->lineno = t.lineno;
+  e->jumpOffsets = t.jumpOffsets;
+}
@@ -0,0 +1,34 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_REGISTER_H
+#define DRIFT_REGISTER_H
+
+#include <map>
+#include <set>
+
+#include "entity.h"
+#include "object.h"
+#include "opcode.h"
+
+// translate stack bytecodes of entity and its functions to three address
+// bytecodes, which take names and constants as operands directly
+//
+// LOAD x, LOAD y, ADD, ASSIGN d  ->  R_ASSIGN ADD d x y
+// LOAD x, CONST 1, LE, F_JUMP l  ->  R_F_JUMP LE x 1 l
+// LOAD x, LOAD y, MUL            ->  R_PUSH MUL x y
+// CONST 1, ASSIGN d              ->  R_MOVE d 1
+void registers(Entity *);
+
+#endif
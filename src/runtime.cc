@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#include "runtime.h"
+#include "ir.h"
+#include "lexer.h"
+#include "parser.h"
+#include "register.h"
+#include "semantic.h"
+#include "system.h"
+#include "util.h"
+
+// compile source code to the main entity, constants are made in current
+// heap, throws exp::Exp
+Entity *compile(const std::string &source, State *state,
+                const Options &options, Inlines *inlines) {
+  // lexer, its tokens and statements are referred by the entities
+  auto lex = new Lexer(source, state);
+
+  lex->tokenizer();
+  if (options.debug)
+    lex->dissembleTokens();
+
+  // parser
+  auto parser = new Parser(lex->tokens, state);
+
+  parser->parse();
+  if (options.debug)
+    parser->dissembleStmts();
+
+  // semantic
+  auto semantic = new Analysis(&parser->statements, state);
+  // compiler
+  auto compiler = new Compiler(parser->statements, parser->lineno, inlines);
+  compiler->compile();
+
+  Entity *main = compiler->entities[0];
+  if (options.opt)
+    ir::optimize(main, options.irdump);
+  if (options.reg)
+    registers(main);
+
+  if (options.dis)
+    for (auto i : compiler->entities)
+      i->dissemble();
+  return main;
+}
+
+// compile source files of directory as standard modules, throws exp::Exp
+void Image::load(const std::string &path) {
+  std::vector<std::string> *fs = getAllFileWithPath(path);
+
+  for (auto i : *fs) {
+    std::string s;
+    if (!fileString(i.c_str(), &s))
+      continue;
+
+    State state;
+    state.filePath = i;
+
+    gc::Scope scope(nullptr); // PERMANENT
+    this->mods.push_back(::compile(s, &state, Options(), &this->inlines));
+  }
+  delete fs;
+}
+
+// compile source code to the main entity, throws exp::Exp
+Entity *Image::compile(const std::string &source, State *state) {
+  gc::Scope scope(nullptr); // PERMANENT
+  return ::compile(source, state, this->options, &this->inlines);
+}
+
+// run source files of directory as standard modules
+void Runtime::load(const std::string &path) {
+  std::vector<std::string> *fs = getAllFileWithPath(path);
+
+  for (auto i : *fs) {
+    std::string s;
+    if (!fileString(i.c_str(), &s))
+      continue;
+
+    Context ctx(this);
+    ctx.state.filePath = i;
+    ctx.run(ctx.compile(s));
+  }
+  delete fs;
+}
+
+// run standard modules of image, its code is not compiled again
+void Runtime::load(const Image &image) {
+  for (auto i : image.mods)
+    Context(this).run(i);
+  this->inlines = image.inlines;
+}
+
+// compile source code to the main entity, throws exp::Exp
+Entity *Context::compile(const std::string &source) {
+  gc::Scope scope(nullptr); // PERMANENT, TASKS RUN IT ON ANY THREAD
+  return ::compile(source, &this->state, this->options, &this->rt->inlines);
+}
+
+// evaluate main entity, throws exp::Exp
+void Context::run(Entity *main) {
+  Runtime::Scope scope(this->rt);
+
+  if (this->options.repl && this->mac != nullptr)
+    // save the current symbol table
+    this->mac->top()->entity = main;
+  else {
+    delete this->mac;
+    // new virtual machine
+    this->mac = new vm(main, &this->rt->mods, this->options.repl,
+                       this->options.dis, &this->state);
+  }
+  this->mac->evaluate();
+  this->mac->join(); // SPAWNED TASKS
+}
+
+// call a function of program with arguments in order, throws exp::Exp
+object::Object *Context::call(const std::string &name,
+                              std::vector<object::Object *> args) {
+  Runtime::Scope scope(this->rt);
+
+  if (this->mac == nullptr) {
+    this->state.kind = exp::RUNTIME_ERROR;
+    this->state.message = "not run of context";
+    throw exp::Exp(&this->state);
+  }
+  return this->mac->call(name, args);
+}
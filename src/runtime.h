@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_RUNTIME_H
+#define DRIFT_RUNTIME_H
+
+#include <string>
+#include <vector>
+
+#include "compiler.h"
+#include "entity.h"
+#include "gc.h"
+#include "module.h"
+#include "object.h"
+#include "state.h"
+#include "vm.h"
+
+// embedding interface of interpreter
+//
+// a runtime owns objects, collector and modules, nothing of it is shared
+// with other runtimes, so that each one may run on its own thread, but a
+// runtime is used by one thread at a time
+//
+// a context is a program in runtime, with its state, names and vm, the
+// contexts of a runtime share its modules
+//
+//    Runtime rt;
+//    rt.load("std");
+//
+//    Context ctx(&rt);
+//    ctx.run(ctx.compile(source));
+//    ctx.call("f", {...});
+//
+// an image is code compiled out of any runtime, its entities, constants
+// and types are permanent and read only, so runtimes of many threads run
+// it without compiling it again
+//
+//    Image image;
+//    image.load("std");
+//    Entity *main = image.compile(source, &state);
+//
+//    Runtime rt;      // ON EACH THREAD
+//    rt.load(image);
+//    Context(&rt).run(main);
+//
+
+// options of context
+struct Options {
+  bool debug = false;  // output tokens and statements
+  bool dis = false;    // output bytecode of entities
+  bool reg = false;    // three address bytecode
+  bool opt = false;    // optimize by passes of ir
+  bool irdump = false; // output ir after each pass
+  bool repl = false;   // names of main are kept between runs
+};
+
+// compile source code to the main entity, constants are made in current
+// heap, throws exp::Exp
+Entity *compile(const std::string &, State *, const Options &, Inlines *);
+
+// compiled standard modules and programs, shared by runtimes
+struct Image {
+  std::vector<Entity *> mods; // main entities of standard modules
+  Inlines inlines;            // small functions of modules
+  Options options;
+
+  Image() = default;
+  Image(const Image &) = delete;
+
+  // compile source files of directory as standard modules, throws exp::Exp
+  void load(const std::string &);
+
+  // compile source code to the main entity, throws exp::Exp
+  Entity *compile(const std::string &, State *);
+};
+
+class Runtime {
+public:
+  gc::Heap heap;                      // objects of runtime
+  std::vector<object::Module *> mods; // modules of runtime
+  Inlines inlines;                    // small functions of modules
+
+  // heap of runtime is the current one of thread, until end of scope
+  struct Scope : gc::Scope {
+    explicit Scope(Runtime *rt) : gc::Scope(&rt->heap) {}
+  };
+
+  Runtime() = default;
+  Runtime(const Runtime &) = delete;
+
+  // run source files of directory as standard modules
+  void load(const std::string &);
+
+  // run standard modules of image, its code is not compiled again
+  void load(const Image &);
+};
+
+class Context {
+private:
+  Runtime *rt;
+
+  vm *mac = nullptr; // created by the first run
+
+public:
+  Options options;
+  State state;
+
+  explicit Context(Runtime *rt, Options options = {})
+      : rt(rt), options(options) {}
+  Context(const Context &) = delete;
+
+  ~Context() { delete mac; }
+
+  // compile source code to the main entity, its constants are permanent as
+  // tasks of program run it on other threads, throws exp::Exp
+  Entity *compile(const std::string &);
+
+  // evaluate main entity, throws exp::Exp
+  void run(Entity *);
+
+  // call a function of program with arguments in order, throws exp::Exp
+  //
+  // arguments are made in the scope of runtime, the return value is kept
+  // until the next run or call
+  object::Object *call(const std::string &,
+                       std::vector<object::Object *> = {});
+};
+
+#endif
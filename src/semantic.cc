@@ -16,6 +16,8 @@
 
 // statement
 void Analysis::analysisStmt(ast::Stmt *stmt) {
+  this->parallel(stmt); // LOOPS IN IT
+
   switch (stmt->kind()) {
   case ast::STMT_EXPR: {
     ast::ExprStmt *e = static_cast<ast::ExprStmt *>(stmt);
@@ -203,4 +205,246 @@ void Analysis::analysisExpr(ast::Expr *expr) {
   default:
     break;
   }
-}
\ No newline at end of file
+}
+
+// blocks of statement
+static std::vector<ast::BlockStmt *> blocks(ast::Stmt *stmt) {
+  switch (stmt->kind()) {
+  case ast::STMT_BLOCK:
+    return {static_cast<ast::BlockStmt *>(stmt)};
+  case ast::STMT_IF: {
+    ast::IfStmt *i = static_cast<ast::IfStmt *>(stmt);
+
+    std::vector<ast::BlockStmt *> v = {i->ifBranch};
+    for (auto &e : i->efBranch)
+      v.push_back(e.second);
+    if (i->nfBranch != nullptr)
+      v.push_back(i->nfBranch);
+    return v;
+  }
+  case ast::STMT_FOR:
+    return {static_cast<ast::ForStmt *>(stmt)->block};
+  case ast::STMT_FOR_IN:
+    return {static_cast<ast::ForInStmt *>(stmt)->block};
+  case ast::STMT_AOP:
+    return {static_cast<ast::AopStmt *>(stmt)->block};
+  case ast::STMT_FUNC:
+    return {static_cast<ast::FuncStmt *>(stmt)->block};
+  case ast::STMT_WHOLE:
+    return {static_cast<ast::WholeStmt *>(stmt)->body};
+  case ast::STMT_PAR:
+    return {static_cast<ast::ParStmt *>(stmt)->block};
+  default:
+    return {};
+  }
+}
+
+// names defined in statement and its blocks
+static void defines(ast::Stmt *stmt, std::set<std::string> &own) {
+  switch (stmt->kind()) {
+  case ast::STMT_VAR:
+    own.insert(static_cast<ast::VarStmt *>(stmt)->name.literal);
+    break;
+  case ast::STMT_FOR:
+    defines(static_cast<ast::ForStmt *>(stmt)->init, own);
+    break;
+  case ast::STMT_FOR_IN:
+    for (auto &i : static_cast<ast::ForInStmt *>(stmt)->names)
+      own.insert(i.literal);
+    break;
+  case ast::STMT_PAR:
+    for (auto &i : static_cast<ast::ParStmt *>(stmt)->names)
+      own.insert(i.literal);
+    break;
+  case ast::STMT_FUNC: {
+    ast::FuncStmt *f = static_cast<ast::FuncStmt *>(stmt);
+
+    own.insert(f->name.literal);
+    for (auto &i : f->arguments)
+      own.insert(i.first->literal);
+  } break;
+  default:
+    break;
+  }
+  for (auto b : blocks(stmt))
+    for (auto i : b->block)
+      defines(i, own);
+}
+
+// parallel loops in statement write only their own names
+void Analysis::parallel(ast::Stmt *stmt) {
+  if (stmt->kind() == ast::STMT_PAR) {
+    ast::ParStmt *p = static_cast<ast::ParStmt *>(stmt);
+
+    std::set<std::string> own;
+    for (auto &i : p->reduce)
+      own.insert(i.second.literal); // PRIVATE OF EACH THREAD
+    defines(p, own);
+
+    this->par = p->names.front().line;
+    for (auto i : p->block->block)
+      this->parallel(i, own, 0, false);
+  }
+  for (auto b : blocks(stmt))
+    for (auto i : b->block)
+      this->parallel(i);
+}
+
+// statement of parallel loop, names it owns and depth of loops in it
+void Analysis::parallel(ast::Stmt *stmt, std::set<std::string> &own,
+                        int loops, bool fn) {
+  switch (stmt->kind()) {
+  case ast::STMT_EXPR:
+    this->parallel(static_cast<ast::ExprStmt *>(stmt)->expr, own);
+    break;
+  case ast::STMT_VAR:
+    if (static_cast<ast::VarStmt *>(stmt)->expr != nullptr)
+      this->parallel(static_cast<ast::VarStmt *>(stmt)->expr, own);
+    break;
+  case ast::STMT_IF: {
+    ast::IfStmt *i = static_cast<ast::IfStmt *>(stmt);
+
+    this->parallel(i->condition, own);
+    for (auto &e : i->efBranch)
+      this->parallel(e.first, own);
+  } break;
+  case ast::STMT_FOR: {
+    ast::ForStmt *f = static_cast<ast::ForStmt *>(stmt);
+
+    this->parallel(f->init, own, loops, fn);
+    this->parallel(f->cond, own, loops, fn);
+    this->parallel(f->more, own, loops, fn);
+  } break;
+  case ast::STMT_FOR_IN:
+    this->parallel(static_cast<ast::ForInStmt *>(stmt)->expr, own);
+    break;
+  case ast::STMT_AOP:
+    if (static_cast<ast::AopStmt *>(stmt)->expr != nullptr)
+      this->parallel(static_cast<ast::AopStmt *>(stmt)->expr, own);
+    break;
+  case ast::STMT_PAR:
+    this->parallel(static_cast<ast::ParStmt *>(stmt)->expr, own);
+    break;
+  case ast::STMT_OUT:
+  case ast::STMT_GO:
+    if (loops == 0 && !fn)
+      error(exp::SHARED_WRITE, "out or go of parallel loop", this->par);
+    break;
+  case ast::STMT_RET:
+  case ast::STMT_YIELD:
+    if (!fn)
+      error(exp::SHARED_WRITE, "ret or yield in parallel loop", this->par);
+    break;
+  default:
+    break;
+  }
+
+  bool loop = stmt->kind() == ast::STMT_FOR ||
+              stmt->kind() == ast::STMT_FOR_IN ||
+              stmt->kind() == ast::STMT_AOP || stmt->kind() == ast::STMT_PAR;
+  for (auto b : blocks(stmt))
+    for (auto i : b->block)
+      this->parallel(i, own, loops + loop,
+                     fn || stmt->kind() == ast::STMT_FUNC ||
+                         stmt->kind() == ast::STMT_WHOLE);
+}
+
+// expression of parallel loop writes only names it owns
+void Analysis::parallel(ast::Expr *expr, std::set<std::string> &own) {
+  // name of written object, its elements or fields
+  auto write = [&](ast::Expr *e) {
+    while (e->kind() == ast::EXPR_INDEX || e->kind() == ast::EXPR_GET ||
+           e->kind() == ast::EXPR_GROUP) {
+      if (e->kind() == ast::EXPR_INDEX)
+        e = static_cast<ast::IndexExpr *>(e)->left;
+      else if (e->kind() == ast::EXPR_GET)
+        e = static_cast<ast::GetExpr *>(e)->expr;
+      else
+        e = static_cast<ast::GroupExpr *>(e)->expr;
+    }
+    if (e->kind() != ast::EXPR_NAME)
+      return; // NEW OBJECT
+    token::Token &t = static_cast<ast::NameExpr *>(e)->token;
+    if (!own.count(t.literal))
+      error(exp::SHARED_WRITE,
+            "parallel loop writes shared name '" + t.literal + "'", t.line);
+  };
+
+  switch (expr->kind()) {
+  case ast::EXPR_BINARY: {
+    ast::BinaryExpr *b = static_cast<ast::BinaryExpr *>(expr);
+
+    if (b->op.kind == token::AS_ADD || b->op.kind == token::AS_SUB ||
+        b->op.kind == token::AS_MUL || b->op.kind == token::AS_DIV ||
+        b->op.kind == token::AS_SUR)
+      write(b->left);
+    this->parallel(b->left, own);
+    this->parallel(b->right, own);
+  } break;
+  case ast::EXPR_ASSIGN: {
+    ast::AssignExpr *a = static_cast<ast::AssignExpr *>(expr);
+
+    write(a->expr);
+    this->parallel(a->expr, own);
+    this->parallel(a->value, own);
+  } break;
+  case ast::EXPR_SET: {
+    ast::SetExpr *s = static_cast<ast::SetExpr *>(expr);
+
+    write(s->expr);
+    this->parallel(s->expr, own);
+    this->parallel(s->value, own);
+  } break;
+  case ast::EXPR_GROUP:
+    this->parallel(static_cast<ast::GroupExpr *>(expr)->expr, own);
+    break;
+  case ast::EXPR_UNARY:
+    this->parallel(static_cast<ast::UnaryExpr *>(expr)->expr, own);
+    break;
+  case ast::EXPR_CALL: {
+    ast::CallExpr *c = static_cast<ast::CallExpr *>(expr);
+
+    this->parallel(c->callee, own);
+    for (auto i : c->arguments)
+      this->parallel(i, own);
+  } break;
+  case ast::EXPR_GET:
+    this->parallel(static_cast<ast::GetExpr *>(expr)->expr, own);
+    break;
+  case ast::EXPR_ARRAY:
+    for (auto i : static_cast<ast::ArrayExpr *>(expr)->elements)
+      this->parallel(i, own);
+    break;
+  case ast::EXPR_TUPLE:
+    for (auto i : static_cast<ast::TupleExpr *>(expr)->elements)
+      this->parallel(i, own);
+    break;
+  case ast::EXPR_MAP:
+    for (auto &i : static_cast<ast::MapExpr *>(expr)->elements) {
+      this->parallel(i.first, own);
+      this->parallel(i.second, own);
+    }
+    break;
+  case ast::EXPR_INDEX: {
+    ast::IndexExpr *i = static_cast<ast::IndexExpr *>(expr);
+
+    this->parallel(i->left, own);
+    this->parallel(i->right, own);
+  } break;
+  case ast::EXPR_SLICE: {
+    ast::SliceExpr *s = static_cast<ast::SliceExpr *>(expr);
+
+    this->parallel(s->left, own);
+    if (s->lo != nullptr)
+      this->parallel(s->lo, own);
+    if (s->hi != nullptr)
+      this->parallel(s->hi, own);
+  } break;
+  case ast::EXPR_NEW:
+    for (auto &i : static_cast<ast::NewExpr *>(expr)->builder)
+      this->parallel(i.second, own);
+    break;
+  default:
+    break;
+  }
+}
@@ -16,6 +16,7 @@
 #define DRIFT_SEMANTIC_H
 
 #include <algorithm>
+#include <set>
 
 #include "ast.h"
 #include "exception.h"
@@ -45,6 +46,17 @@ private:
     throw exp::Exp(state);
   }
 
+  int par = -1; // line of parallel loop being checked
+
+  // parallel loops in statement write only their own names
+  void parallel(ast::Stmt *);
+
+  // statement of parallel loop, names it owns and depth of loops in it
+  void parallel(ast::Stmt *, std::set<std::string> &, int, bool);
+
+  // expression of parallel loop writes only names it owns
+  void parallel(ast::Expr *, std::set<std::string> &);
+
 public:
   explicit Analysis(std::vector<ast::Stmt *> *stmts, State *state) {
     this->statements = stmts;
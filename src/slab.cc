@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+
+#include <cstdio>
+#include <mutex>
+#include <new>
+
+#include "slab.h"
+
+namespace slab {
+// free slot, linked through its first bytes
+struct Slot {
+  Slot *next;
+};
+
+// size class of a thread
+struct Class {
+  Slot *list = nullptr; // free slots
+  long count = 0;       // of free list
+  char *bump = nullptr; // next unused slot of slab
+  char *end = nullptr;  // end of slab
+
+  long alloc = 0, free = 0, slabs = 0;
+};
+
+// free slots given back by threads, taken by any of them in batches, so
+// that slots freed by another thread than the one allocated them are reused
+static struct Depot {
+  std::mutex m;
+  std::vector<std::pair<Slot *, long>> batches[classes]; // LIST AND LENGTH
+} *depot = new Depot; // NEVER FREED, THREADS MAY END AFTER MAIN
+
+// slots of a batch, those of a slab
+static long batch(int k) { return chunk / ((k + 1) * grain); }
+
+// list of n slots into depot
+static void give(int k, Slot *list, long n) {
+  std::lock_guard<std::mutex> l(depot->m);
+  depot->batches[k].push_back({list, n});
+}
+
+// size classes of current thread, its free slots are given to depot at the
+// end of thread
+struct Local {
+  Class c[classes];
+
+  ~Local() {
+    for (int k = 0; k < classes; k++) {
+      int size = (k + 1) * grain;
+      for (; c[k].bump != nullptr && c[k].end - c[k].bump >= size;
+           c[k].bump += size) { // UNUSED OF SLAB
+        Slot *s = reinterpret_cast<Slot *>(c[k].bump);
+        s->next = c[k].list;
+        c[k].list = s;
+        c[k].count++;
+      }
+      if (c[k].list != nullptr)
+        give(k, c[k].list, c[k].count);
+    }
+  }
+};
+
+static thread_local Local local; // OF CURRENT THREAD
+
+void *alloc(std::size_t n) {
+  if (n > grain * classes)
+    return ::operator new(n); // LARGE
+
+  int k = (n - 1) / grain;
+  int size = (k + 1) * grain;
+  Class &c = local.c[k];
+  c.alloc++;
+
+  if (c.list == nullptr && (c.bump == nullptr || c.end - c.bump < size)) {
+    std::lock_guard<std::mutex> l(depot->m);
+    if (!depot->batches[k].empty()) {
+      c.list = depot->batches[k].back().first; // BATCH OF OTHER THREAD
+      c.count = depot->batches[k].back().second;
+      depot->batches[k].pop_back();
+    }
+  }
+
+  if (c.list != nullptr) {
+    Slot *s = c.list;
+    c.list = s->next;
+    c.count--;
+    return s;
+  }
+
+  if (c.bump == nullptr || c.end - c.bump < size) {
+    c.bump = static_cast<char *>(::operator new(chunk)); // NEW SLAB
+    c.end = c.bump + chunk;
+    c.slabs++;
+  }
+  void *p = c.bump;
+  c.bump += size;
+  return p;
+}
+
+void free(void *p, std::size_t n) {
+  if (p == nullptr)
+    return;
+  if (n > grain * classes) {
+    ::operator delete(p); // LARGE
+    return;
+  }
+
+  int k = (n - 1) / grain;
+  Class &c = local.c[k];
+  c.free++;
+
+  Slot *s = static_cast<Slot *>(p);
+  s->next = c.list;
+  c.list = s;
+
+  // SURPLUS OF TWO BATCHES, THE FIRST ONE TO DEPOT
+  if (++c.count >= 2 * batch(k)) {
+    Slot *last = c.list;
+    for (long i = 1; i < batch(k); i++)
+      last = last->next;
+    Slot *first = c.list;
+    c.list = last->next;
+    last->next = nullptr;
+    c.count -= batch(k);
+    give(k, first, batch(k));
+  }
+}
+
+std::vector<Stat> stats() {
+  std::vector<Stat> r;
+  for (int k = 0; k < classes; k++)
+    if (local.c[k].alloc != 0)
+      r.push_back(Stat{(k + 1) * grain, local.c[k].alloc, local.c[k].free,
+                       local.c[k].slabs});
+  return r;
+}
+
+void dissemble() {
+  printf("SLAB: \n");
+  printf("%10s %12s %12s %12s %8s\n", "SIZE", "ALLOC", "FREE", "LIVE",
+         "SLABS");
+  for (auto &i : stats())
+    printf("%10d %12ld %12ld %12ld %8ld\n", i.size, i.alloc, i.free,
+           i.alloc - i.free, i.slabs);
+}
+}; // namespace slab
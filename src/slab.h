@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+
+#ifndef DRIFT_SLAB_H
+#define DRIFT_SLAB_H
+
+#include <cstddef>
+#include <vector>
+
+// size-class allocator of runtime objects and frames
+//
+// each size class carves slots out of large slabs, freed slots are linked
+// into a free list of the thread which frees them, its surplus and the rest
+// at the end of thread are given to a depot for any thread
+//
+namespace slab {
+constexpr int grain = 16;        // bytes between size classes
+constexpr int classes = 16;      // largest slot is grain * classes bytes
+constexpr int chunk = 64 * 1024; // bytes of a slab
+
+void *alloc(std::size_t);       // memory of size, from its class
+void free(void *, std::size_t); // back to the free list of its class
+
+// statistics of size class
+struct Stat {
+  int size;   // bytes of slot
+  long alloc; // slots taken
+  long free;  // slots given back
+  long slabs; // slabs of class
+};
+
+std::vector<Stat> stats(); // classes used by current thread
+void dissemble();          // output statistics
+}; // namespace slab
+
+#endif
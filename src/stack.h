@@ -16,6 +16,7 @@
 #define DRIFT_STACK_H
 
 #include <iostream>
+#include <utility>
 
 // Type stack structure
 template <class T> class Stack {
@@ -29,6 +30,11 @@ public:
   // First, alloc memory to default capacity 4
   explicit Stack() { this->elements = new T[capacity]; }
 
+  // Alloc memory to the given capacity
+  explicit Stack(int capacity) : capacity(capacity) {
+    this->elements = new T[capacity];
+  }
+
   // After program out to free elements
   ~Stack() { delete[] elements; }
 
@@ -64,10 +70,57 @@ public:
     }
   }
 
+  // Exchange elements with other stack
+  void swap(Stack &o) {
+    std::swap(this->capacity, o.capacity);
+    std::swap(this->count, o.count);
+    std::swap(this->elements, o.elements);
+  }
+
+    // Drop elements above the position
+  void truncate(int pos) {
+    if (pos < count)
+      this->count = pos;
+  }
+
   // Stringer
   std::string stringer() {
     return "<Stack count = " + std::to_string(count) + ">";
   }
 };
 
+// Window of a shared stack, from base to the top
+template <class T> class Window {
+public:
+  Stack<T> *stack = nullptr; /* Shared stack */
+  int base = 0;              /* First element of window */
+
+  // Push a element
+  void push(T t) { this->stack->push(t); }
+
+  // Return the element of position within window
+  T at(int pos) { return this->stack->at(base + pos); }
+
+  // Pop element
+  T pop() { return this->stack->pop(); }
+
+  // Top element
+  T top() { return this->stack->top(); }
+
+  // Return length of elements within window
+  int len() { return this->stack->len() - base; }
+
+  // Return is empty of window
+  bool empty() { return len() == 0; }
+
+  // Clear all elements of window
+  void clear() { this->stack->truncate(base); }
+
+  // Stringer
+  std::string stringer() {
+    return "<Window base = " + std::to_string(base) +
+           " count = " + std::to_string(len()) + ">";
+  }
+};
+
 #endif
\ No newline at end of file
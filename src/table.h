@@ -23,30 +23,63 @@
 struct Table {
   std::map<std::string, object::Object *> symbols; /* Elements */
 
-  // Remove a name
-  void remove(std::string n) { symbols.erase(n); }
+  Table *parent = nullptr; /* Enclosing table of caller */
+
+  // Remove a name, the name of parent is hidden with an empty object
+  void remove(const std::string &n) {
+    auto iter = symbols.find(n);
+    if (iter != symbols.end())
+      object::release(iter->second);
+
+    if (parent != nullptr && parent->lookUp(n) != nullptr)
+      symbols[n] = nullptr;
+    else
+      symbols.erase(n);
+  }
 
   // Clear all elements
-  void clear() { symbols.clear(); }
+  void clear() {
+    for (auto &i : symbols)
+      object::release(i.second);
+    symbols.clear();
+  }
 
   // Return is empty of elements
   bool empty() { return symbols.empty(); }
 
-  // Lookup a name
-  object::Object *lookUp(std::string n) {
-    for (auto i : symbols)
-      if (i.first == n)
-        return i.second;
+  // Lookup a name, then the parent
+  object::Object *lookUp(const std::string &n) {
+    for (Table *t = this; t != nullptr; t = t->parent) {
+      auto iter = t->symbols.find(n);
+      if (iter != t->symbols.end())
+        return iter->second;
+    }
+    return nullptr;
+  }
+
+  // Table holds a name, this or the parent
+  Table *owner(const std::string &n) {
+    for (Table *t = this; t != nullptr; t = t->parent)
+      if (t->symbols.count(n))
+        return t;
     return nullptr;
   }
 
   // To emit a name with its object
-  void emit(std::string n, object::Object *o) { symbols[n] = o; }
+  void emit(const std::string &n, object::Object *o) {
+    object::Object *&s = symbols[n];
+
+    object::hold(o);
+    object::release(s);
+    s = o;
+  }
 
   // Dissemble symbols in table
   void dissemble() {
     printf("SYMBOL: \n");
     for (auto i : symbols) {
+      if (i.second == nullptr)
+        continue; // REMOVED
       printf("%20s: %40s %10p\n", i.first.c_str(),
              i.second->rawStringer().c_str(), i.second);
     }
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_TASK_H
+#define DRIFT_TASK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#include "frame.h"
+#include "object.h"
+#include "state.h"
+
+class vm;
+
+// bytes of C stack of task, reserved, its pages are taken as they are touched
+constexpr size_t taskStack = 8 * 1024 * 1024;
+
+// bytes below C stack of task never mapped, so an overflow faults at once
+constexpr size_t taskGuard = 64 * 1024;
+
+// bytes of C stack left to builtins, a call deeper than it is an error
+constexpr size_t stackMargin = 256 * 1024;
+
+// lightweight task, a function running on a C stack, a vm and a heap of
+// its own, so that it is handed from thread to thread as a whole
+//
+// tasks run on a thread of each core, the running one goes on until it is
+// blocked by a channel, sleep or descriptor, or it returns, then the thread
+// takes the first ready one of its queue, or steals half of the queue of
+// another thread if its own is empty
+//
+// a task has a copy of the names of program made as it is spawned, its
+// arguments and the values sent to it are copied too, tasks share channels
+// and nothing else, the program itself is the main task on its own thread
+//
+struct Group;
+
+struct Task {
+  ucontext_t context;     // registers of suspended task
+  char *cstack = nullptr; // LOWEST OF C STACK, NONE OF MAIN TASK
+
+  vm *v = nullptr;                    // OF TASK, NONE OF MAIN TASK
+  std::unique_ptr<gc::Heap> heap;     // objects of task
+  std::vector<object::Module *> mods; // of program as it is spawned
+  State state;                        // of errors of task
+
+  Group *group = nullptr; // of program
+
+  object::Func *func = nullptr;       // function of task
+  std::vector<object::Object *> args; // its arguments in order
+
+  int conn = -1; // socket of HTTP connection, its requests are given to func
+
+  // by channel, timer or descriptor, guarded by scheduler like all below
+  bool blocked = false;
+  bool parked = false; // its registers are saved, to be resumed if woken
+  bool done = false;   // function returned
+
+  std::chrono::steady_clock::time_point wake; // end of sleep
+
+  Task() = default;
+  Task(const Task &) = delete;
+
+  ~Task() {
+    if (cstack != nullptr)
+      munmap(cstack - taskGuard, taskGuard + taskStack);
+  }
+};
+
+// tasks spawned by a program and by its tasks, the main task is woken as
+// one of them fails or all of them are blocked
+struct Group {
+  Task main; // THE PROGRAM, BLOCKED ON ITS THREAD
+
+  std::condition_variable woken; // OF MAIN TASK
+  std::vector<Task *> tasks;     // NOT FREED
+
+  int active = 0;   // ready or running, not the main one
+  int timed = 0;    // blocked by timer
+  int awaiting = 0; // blocked by descriptor
+
+  std::atomic<bool> stop{false}; // failed or ended, tasks are ended
+  std::exception_ptr failure;    // error of a task, thrown in main one
+
+  // none of tasks and main task goes on unless it is woken by another
+  bool stuck() { return active == 0 && timed == 0 && awaiting == 0; }
+};
+
+// tasks awaiting a descriptor to be readable or writable
+struct Watch {
+  Task *reader = nullptr;
+  Task *writer = nullptr;
+  bool added = false; // to epoll of scheduler
+};
+
+#endif
@@ -18,6 +18,7 @@ void initializeKeyword(std::map<std::string, token::Kind> *map) {
   map->insert(std::make_pair("new", NEW)); // 12
   map->insert(std::make_pair("mod", MOD)); // 13
   map->insert(std::make_pair("del", DEL)); // 14
+  map->insert(std::make_pair("yield", YIELD)); // 15
 }
 
 // Return the kind of token if its keyword
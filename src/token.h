@@ -22,7 +22,7 @@
 // tokens
 namespace token {
 // total number of token for drift
-constexpr int len = 55;
+constexpr int len = 56;
 // token type
 enum Kind {
   IDENT, // identifier literal
@@ -90,6 +90,7 @@ enum Kind {
   NEW, // 12
   MOD, // 13
   DEL, // 14
+  YIELD, // 15
 };
 
 // returns a string of each type
@@ -103,6 +104,7 @@ static std::string kindString[len] = {
     "L_BRACKET", "R_BRACKET", "UNDERLINE", "EFF",     "USE",       "DEF",
     "RET",       "END",       "IF",        "EF",      "NF",        "FOR",
     "AOP",       "OUT",       "GO",        "NEW",     "MOD",       "DEL",
+    "YIELD",
 };
 
 //  token structure
@@ -31,6 +31,8 @@ enum TypeKind {
   T_TUPLE, // (T)
   T_FUNC,  // |A| -> R
   T_USER,  // user
+  T_GEN,   // gen
+  T_CHAN,  // chan
 };
 
 // basic type for drift
@@ -40,6 +42,8 @@ enum TypeKind {
 #define S_STR "str"     // 3
 #define S_CHAR "char"   // 4
 #define S_BOOL "bool"   // 5
+#define S_GEN "gen"     // 6
+#define S_CHAN "chan"   // 7
 
 // TYPE
 class Type {
@@ -175,4 +179,20 @@ public:
   TypeKind kind() override { return T_USER; }
 };
 
+// generator
+class Gen : public Type {
+public:
+  std::string stringer() override { return "<Gen>"; }
+
+  TypeKind kind() override { return T_GEN; }
+};
+
+// channel of tasks
+class Chan : public Type {
+public:
+  std::string stringer() override { return "<Chan>"; }
+
+  TypeKind kind() override { return T_CHAN; }
+};
+
 #endif
\ No newline at end of file
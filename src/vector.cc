@@ -0,0 +1,349 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // X86
+
+#define VEC_X86
+#define AVX2 __attribute__((target("avx2")))
+
+#endif
+
+#include <algorithm>
+
+#include "vector.h"
+
+namespace vec {
+
+// return whether the kernels use AVX2
+bool avx2() {
+#ifdef VEC_X86
+  static bool ok = __builtin_cpu_supports("avx2"); // DETECT ONCE
+  return ok;
+#else
+  return false;
+#endif
+}
+
+#ifdef VEC_X86
+// 8 ints at position
+#define LOAD_I(p) _mm256_loadu_si256((const __m256i *)(p))
+// 4 floats at position
+#define LOAD_F(p) _mm256_loadu_pd(p)
+
+// lanes of ints added, wrapping as the vm does
+AVX2 static unsigned reduceI(__m256i v) {
+  int buf[8];
+  _mm256_storeu_si256((__m256i *)buf, v);
+
+  unsigned r = 0;
+  for (int k = 0; k < 8; k++)
+    r += buf[k];
+  return r;
+}
+
+// lanes of floats added
+AVX2 static double reduceF(__m256d v) {
+  double buf[4];
+  _mm256_storeu_pd(buf, v);
+  return (buf[0] + buf[1]) + (buf[2] + buf[3]);
+}
+
+AVX2 static int sumAvx(const int *x, int n) {
+  __m256i s = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    s = _mm256_add_epi32(s, LOAD_I(x + i));
+
+  unsigned r = reduceI(s);
+  for (; i < n; i++)
+    r += x[i];
+  return r;
+}
+
+AVX2 static double sumAvx(const double *x, int n) {
+  __m256d s = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    s = _mm256_add_pd(s, LOAD_F(x + i));
+
+  double r = reduceF(s);
+  for (; i < n; i++)
+    r += x[i];
+  return r;
+}
+
+AVX2 static int minAvx(const int *x, int n, bool less) {
+  __m256i m = _mm256_set1_epi32(x[0]);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    m = less ? _mm256_min_epi32(m, LOAD_I(x + i))
+             : _mm256_max_epi32(m, LOAD_I(x + i));
+
+  int buf[8];
+  _mm256_storeu_si256((__m256i *)buf, m);
+
+  int r = x[0];
+  for (int k = 0; k < 8; k++)
+    r = less ? std::min(r, buf[k]) : std::max(r, buf[k]);
+  for (; i < n; i++)
+    r = less ? std::min(r, x[i]) : std::max(r, x[i]);
+  return r;
+}
+
+AVX2 static double minAvx(const double *x, int n, bool less) {
+  __m256d m = _mm256_set1_pd(x[0]);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    m = less ? _mm256_min_pd(m, LOAD_F(x + i)) : _mm256_max_pd(m, LOAD_F(x + i));
+
+  double buf[4];
+  _mm256_storeu_pd(buf, m);
+
+  double r = x[0];
+  for (int k = 0; k < 4; k++)
+    r = less ? std::min(r, buf[k]) : std::max(r, buf[k]);
+  for (; i < n; i++)
+    r = less ? std::min(r, x[i]) : std::max(r, x[i]);
+  return r;
+}
+
+AVX2 static int dotAvx(const int *x, const int *y, int n) {
+  __m256i s = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    s = _mm256_add_epi32(s, _mm256_mullo_epi32(LOAD_I(x + i), LOAD_I(y + i)));
+
+  unsigned r = reduceI(s);
+  for (; i < n; i++)
+    r += (unsigned)x[i] * (unsigned)y[i];
+  return r;
+}
+
+AVX2 static double dotAvx(const double *x, const double *y, int n) {
+  __m256d s = _mm256_setzero_pd();
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    s = _mm256_add_pd(s, _mm256_mul_pd(LOAD_F(x + i), LOAD_F(y + i)));
+
+  double r = reduceF(s);
+  for (; i < n; i++)
+    r += x[i] * y[i];
+  return r;
+}
+
+AVX2 static void scaleAvx(const int *x, int k, int *out, int n) {
+  __m256i v = _mm256_set1_epi32(k);
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_si256((__m256i *)(out + i),
+                        _mm256_mullo_epi32(LOAD_I(x + i), v));
+  for (; i < n; i++)
+    out[i] = (unsigned)x[i] * (unsigned)k;
+}
+
+AVX2 static void scaleAvx(const double *x, double k, double *out, int n) {
+  __m256d v = _mm256_set1_pd(k);
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(LOAD_F(x + i), v));
+  for (; i < n; i++)
+    out[i] = x[i] * k;
+}
+
+AVX2 static void addAvx(const int *x, const int *y, int *out, int n) {
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_si256((__m256i *)(out + i),
+                        _mm256_add_epi32(LOAD_I(x + i), LOAD_I(y + i)));
+  for (; i < n; i++)
+    out[i] = (unsigned)x[i] + (unsigned)y[i];
+}
+
+AVX2 static void addAvx(const double *x, const double *y, double *out, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(out + i, _mm256_add_pd(LOAD_F(x + i), LOAD_F(y + i)));
+  for (; i < n; i++)
+    out[i] = x[i] + y[i];
+}
+
+AVX2 static int findAvx(const int *x, int v, int n) {
+  __m256i k = _mm256_set1_epi32(v);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    int m = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(LOAD_I(x + i), k)));
+    if (m != 0)
+      return i + __builtin_ctz(m); // FIRST LANE
+  }
+  for (; i < n; i++)
+    if (x[i] == v)
+      return i;
+  return -1;
+}
+
+AVX2 static int findAvx(const double *x, double v, int n) {
+  __m256d k = _mm256_set1_pd(v);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int m = _mm256_movemask_pd(_mm256_cmp_pd(LOAD_F(x + i), k, _CMP_EQ_OQ));
+    if (m != 0)
+      return i + __builtin_ctz(m); // FIRST LANE
+  }
+  for (; i < n; i++)
+    if (x[i] == v)
+      return i;
+  return -1;
+}
+
+AVX2 static int countAvx(const int *x, int v, int n) {
+  __m256i k = _mm256_set1_epi32(v);
+  __m256i c = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+    c = _mm256_sub_epi32(c, _mm256_cmpeq_epi32(LOAD_I(x + i), k)); // -1
+
+  int r = reduceI(c);
+  for (; i < n; i++)
+    r += x[i] == v;
+  return r;
+}
+
+AVX2 static int countAvx(const double *x, double v, int n) {
+  __m256d k = _mm256_set1_pd(v);
+  int r = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+    r += __builtin_popcount(
+        _mm256_movemask_pd(_mm256_cmp_pd(LOAD_F(x + i), k, _CMP_EQ_OQ)));
+  for (; i < n; i++)
+    r += x[i] == v;
+  return r;
+}
+
+#undef LOAD_I
+#undef LOAD_F
+
+// call kernel of AVX2 if the cpu supports it
+#define DISPATCH(call)                                                         \
+  if (avx2())                                                                  \
+    return call;
+#else
+#define DISPATCH(call)
+#endif
+
+int sum(const int *x, int n) {
+  DISPATCH(sumAvx(x, n));
+  unsigned r = 0;
+  for (int i = 0; i < n; i++)
+    r += x[i];
+  return r;
+}
+
+double sum(const double *x, int n) {
+  DISPATCH(sumAvx(x, n));
+  double r = 0;
+  for (int i = 0; i < n; i++)
+    r += x[i];
+  return r;
+}
+
+int min(const int *x, int n) {
+  DISPATCH(minAvx(x, n, true));
+  return *std::min_element(x, x + n);
+}
+
+double min(const double *x, int n) {
+  DISPATCH(minAvx(x, n, true));
+  return *std::min_element(x, x + n);
+}
+
+int max(const int *x, int n) {
+  DISPATCH(minAvx(x, n, false));
+  return *std::max_element(x, x + n);
+}
+
+double max(const double *x, int n) {
+  DISPATCH(minAvx(x, n, false));
+  return *std::max_element(x, x + n);
+}
+
+int dot(const int *x, const int *y, int n) {
+  DISPATCH(dotAvx(x, y, n));
+  unsigned r = 0;
+  for (int i = 0; i < n; i++)
+    r += (unsigned)x[i] * (unsigned)y[i];
+  return r;
+}
+
+double dot(const double *x, const double *y, int n) {
+  DISPATCH(dotAvx(x, y, n));
+  double r = 0;
+  for (int i = 0; i < n; i++)
+    r += x[i] * y[i];
+  return r;
+}
+
+void scale(const int *x, int k, int *out, int n) {
+  DISPATCH(scaleAvx(x, k, out, n));
+  for (int i = 0; i < n; i++)
+    out[i] = (unsigned)x[i] * (unsigned)k;
+}
+
+void scale(const double *x, double k, double *out, int n) {
+  DISPATCH(scaleAvx(x, k, out, n));
+  for (int i = 0; i < n; i++)
+    out[i] = x[i] * k;
+}
+
+void add(const int *x, const int *y, int *out, int n) {
+  DISPATCH(addAvx(x, y, out, n));
+  for (int i = 0; i < n; i++)
+    out[i] = (unsigned)x[i] + (unsigned)y[i];
+}
+
+void add(const double *x, const double *y, double *out, int n) {
+  DISPATCH(addAvx(x, y, out, n));
+  for (int i = 0; i < n; i++)
+    out[i] = x[i] + y[i];
+}
+
+int find(const int *x, int v, int n) {
+  DISPATCH(findAvx(x, v, n));
+  for (int i = 0; i < n; i++)
+    if (x[i] == v)
+      return i;
+  return -1;
+}
+
+int find(const double *x, double v, int n) {
+  DISPATCH(findAvx(x, v, n));
+  for (int i = 0; i < n; i++)
+    if (x[i] == v)
+      return i;
+  return -1;
+}
+
+int count(const int *x, int v, int n) {
+  DISPATCH(countAvx(x, v, n));
+  return std::count(x, x + n, v);
+}
+
+int count(const double *x, double v, int n) {
+  DISPATCH(countAvx(x, v, n));
+  return std::count(x, x + n, v);
+}
+#undef DISPATCH
+}; // namespace vec
@@ -0,0 +1,47 @@
+//
+// Copyright (c) 2021 bingxio（丙杺，黄菁）. All rights reserved.
+//
+
+// GNU General Public License, more to see file: LICENSE
+// https://www.gnu.org/licenses
+
+//          THE DRIFT PROGRAMMING LANGUAGE
+//
+//          https://github.com/bingxio/drift
+//
+//          https://www.drift-lang.fun/
+//
+
+#ifndef DRIFT_VECTOR_H
+#define DRIFT_VECTOR_H
+
+// kernels over contiguous numbers, with AVX2 if the cpu supports it
+namespace vec {
+// return whether the kernels use AVX2
+bool avx2();
+
+int sum(const int *, int);       // sum of elements
+double sum(const double *, int); // sum of elements
+
+int min(const int *, int);       // minimum of elements
+double min(const double *, int); // minimum of elements
+int max(const int *, int);       // maximum of elements
+double max(const double *, int); // maximum of elements
+
+int dot(const int *, const int *, int);          // sum of products
+double dot(const double *, const double *, int); // sum of products
+
+void scale(const int *, int, int *, int);          // each multiplied by
+void scale(const double *, double, double *, int); // each multiplied by
+
+void add(const int *, const int *, int *, int);          // each added
+void add(const double *, const double *, double *, int); // each added
+
+int find(const int *, int, int);       // index of first equal, -1 if none
+int find(const double *, double, int); // index of first equal, -1 if none
+
+int count(const int *, int, int);       // number of equal
+int count(const double *, double, int); // number of equal
+}; // namespace vec
+
+#endif
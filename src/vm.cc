@@ -12,6 +12,26 @@
 //          https://www.drift-lang.fun/
 //
 
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include "vm.h"
 
 // top frame
@@ -20,77 +40,238 @@ Frame *vm::top() { return frames.back(); }
 // main frame
 Frame *vm::main() { return frames.front(); }
 
+// a frame from pool, or new one if pool is empty
+Frame *vm::newFrame(Entity *e) {
+  if (this->pool.empty())
+    return new Frame(e);
+  Frame *f = this->pool.back();
+  this->pool.pop_back();
+
+  f->reset(e); // REUSE
+  return f;
+}
+
+// push a frame and open its window of value stack
+void vm::pushFrame(Frame *f) {
+  f->data.stack = &this->stack;
+  f->data.base = this->stack.len();
+
+  this->frames.push_back(f);
+}
+
+// pop the top frame and drop its values
+void vm::popFrame() {
+  top()->data.clear();
+  this->frames.pop_back();
+}
+
 // push object to the current frame
-void vm::pushData(object::Object *obj) { top()->data.push(obj); }
+void vm::pushData(object::Object *obj) { this->stack.push(obj); }
 
 // pop the top of data stack
-object::Object *vm::popData() { return top()->data.pop(); }
+object::Object *vm::popData() { return this->stack.pop(); }
 
 #define PUSH(obj) this->pushData(obj) // PUSH
 #define POP this->popData             // POP
 
+// fewest elements of slice sharing the storage, smaller ones are copied
+constexpr int viewLeast = 16;
+
+// new object, in scratch of the frame if it is local
+template <class T, class... A> T *vm::make(A &&...args) {
+  void *p = nullptr;
+  if (this->local)
+    p = top()->take(sizeof(T));
+  this->local = false;
+
+  if (p == nullptr)
+    return new T(std::forward<A>(args)...); // HEAP
+
+  T *o = ::new (p) T(std::forward<A>(args)...);
+  o->local = true;
+  top()->locals.push_back(o);
+  return o;
+}
+
 // emit new name of table to the current frame
-void vm::emitTable(std::string name, object::Object *obj) {
-  if (this->lookUp(name) != nullptr) {
-    // REPLACE
-    top()->tb.remove(name);
-  }
-  // STORE
-  top()->tb.emit(name, obj);
+void vm::emitTable(const std::string &name, object::Object *obj) {
+  top()->tb.emit(name, obj); // STORE OR REPLACE
 }
 
 // emit some objects in module to the current frame
 void vm::emitModule(std::vector<object::Module *> m) {
+  std::map<object::Object *, object::Object *> done;
   for (auto i : m)
     for (auto k : i->f->tb.symbols)
-      this->emitTable(k.first, k.second);
+      this->emitTable(k.first, this->own != nullptr // OF PROGRAM, COPIED
+                                   ? this->transfer(k.second, done)
+                                   : k.second);
 }
 
 // look up a name
-object::Object *vm::lookUp(std::string n) {
-  if (!top()->tb.empty() &&
-      // check
-      top()->tb.symbols.count(n) != 0) {
-    return top()->tb.symbols.at(n); // GET
-  }
-  return nullptr;
+object::Object *vm::lookUp(const std::string &n) {
+  return top()->tb.lookUp(n); // GET
 }
 
 // look up a name from main frame
-object::Object *vm::lookUpMainFrame(std::string n) {
-  if (!main()->tb.empty() &&
-      // check
-      main()->tb.symbols.count(n) != 0) {
-    return main()->tb.symbols.at(n); // GET
-  }
-  return nullptr;
+object::Object *vm::lookUpMainFrame(const std::string &n) {
+  return main()->tb.lookUp(n); // GET
 }
 
-#define GET_OFFSET(ip) top()->entity->offsets.at(ip)
+// look up a name to be written in place
+object::Object *vm::writable(const std::string &name) {
+  object::Object *obj = this->lookUp(name);
+  if (obj == nullptr)
+    error("not defined name '" + name + "'");
+
+  // COPY ON WRITE
+  if (object::shared(obj)) {
+    obj = obj->kind() == object::ARRAY
+              ? (object::Object *)static_cast<object::Array *>(obj)->clone()
+              : static_cast<object::Map *>(obj)->clone();
+    Table *t = top()->tb.owner(name);
+    if (this->worker && !this->mine(t))
+      error("parallel loop writes shared name '" + name + "'");
+    if (t != &top()->tb)
+      gc::write(top()->up); // TABLE OF WHOLE
+    t->emit(name, obj);
+  }
+  return obj;
+}
 
 // first to end constant iterator for current frame's entity
-object::Object *vm::retConstant() {
-  return top()->entity->constants.at(GET_OFFSET(op));
+object::Object *vm::retConstant(int *ip) {
+  return top()->entity->constants.at(this->retOffset(ip));
 }
 
 // first to end
-Type *vm::retType() { return top()->entity->types.at(GET_OFFSET(op)); }
+Type *vm::retType(int *ip) {
+  return top()->entity->types.at(this->retOffset(ip));
+}
 
 // first to end
-std::string vm::retName() { return top()->entity->names.at(GET_OFFSET(op)); }
+std::string vm::retName(int *ip) {
+  return top()->entity->names.at(this->retOffset(ip));
+}
 
 // first to end
-int vm::retOffset() { return GET_OFFSET(op); }
+int vm::retOffset(int *ip) { return top()->entity->operand(*ip); }
+
+// operand of three address bytecode, constant or value of name
+object::Object *vm::retOperand(int *ip) {
+  int v = this->retOffset(ip);
+  if (v & 1)
+    return top()->entity->constants.at(v >> 1); // CONST
+
+  const std::string &name = top()->entity->names.at(v >> 1);
+  object::Object *obj = this->lookUp(name); // NAME
+
+  if (obj == nullptr)
+    error("not defined name '" + name + "'");
+  return obj;
+}
 
 // throw an exception
 void vm::error(std::string message) {
   this->state->kind = exp::RUNTIME_ERROR;
   this->state->message = message;
-  this->state->line = top()->entity->lineno.at(this->lp); // line no of bytecode
+  this->state->line = top()->entity->line(this->lp); // line no of bytecode
 
   throw exp::Exp(state);
 }
 
+// arithmetic and comparison of numbers, + of strings
+object::Object *vm::arith(byte::Code co, object::Object *x,
+                          object::Object *y) {
+#define ARITH_OP(TI, TF, OP)                                                   \
+  if (x->kind() == object::INT) {                                              \
+    int l = static_cast<object::Int *>(x)->value;                              \
+    if (y->kind() == object::INT)                                              \
+      return new TI(l OP static_cast<object::Int *>(y)->value);                \
+    if (y->kind() == object::FLOAT)                                            \
+      return new TF(l OP static_cast<object::Float *>(y)->value);              \
+    return nullptr;                                                            \
+  }                                                                            \
+  if (x->kind() == object::FLOAT) {                                            \
+    double l = static_cast<object::Float *>(x)->value;                         \
+    if (y->kind() == object::INT)                                              \
+      return new TF(l OP static_cast<object::Int *>(y)->value);                \
+    if (y->kind() == object::FLOAT)                                            \
+      return new TF(l OP static_cast<object::Float *>(y)->value);              \
+    return nullptr;                                                            \
+  }
+
+  switch (co) {
+  case byte::ADD: {
+    ARITH_OP(object::Int, object::Float, +);
+
+    // <Str> + <Str>
+    if (x->kind() == object::STR && y->kind() == object::STR) {
+      object::Str *l = static_cast<object::Str *>(x);
+      object::Str *r = static_cast<object::Str *>(y);
+
+      if (l->longer || r->longer)
+        error("cannot plus long string literal");
+      return new object::Str(l->value + r->value);
+    }
+    error("unsupport type to + operator");
+    break;
+  }
+  case byte::SUB: {
+    ARITH_OP(object::Int, object::Float, -);
+    error("unsupport type to - operator");
+    break;
+  }
+  case byte::MUL: {
+    ARITH_OP(object::Int, object::Float, *);
+    error("unsupport type to * operator");
+    break;
+  }
+  case byte::DIV: {
+    if ((x->kind() == object::INT || x->kind() == object::FLOAT) &&
+        ((y->kind() == object::INT &&
+          static_cast<object::Int *>(y)->value == 0) ||
+         (y->kind() == object::FLOAT &&
+          static_cast<object::Float *>(y)->value == 0)))
+      error("division by zero");
+
+    ARITH_OP(object::Float, object::Float, /);
+    error("unsupport type to / operator");
+    break;
+  }
+  case byte::SUR: {
+    // <Int> % <Int>
+    if (x->kind() == object::INT && y->kind() == object::INT)
+      return new object::Int(static_cast<object::Int *>(x)->value %
+                             static_cast<object::Int *>(y)->value);
+    error("unsupport type to % operator");
+    break;
+  }
+  case byte::GR: {
+    ARITH_OP(object::Bool, object::Bool, >);
+    error("unsupport type to > operator");
+    break;
+  }
+  case byte::GR_E: {
+    ARITH_OP(object::Bool, object::Bool, >=);
+    error("unsupport type to >= operator");
+    break;
+  }
+  case byte::LE: {
+    ARITH_OP(object::Bool, object::Bool, <);
+    error("unsupport type to < operator");
+    break;
+  }
+  case byte::LE_E: {
+    ARITH_OP(object::Bool, object::Bool, <=);
+    error("unsupport type to <= operator");
+    break;
+  }
+  }
+#undef ARITH_OP
+  return nullptr;
+}
+
 // are the comparison types the same
 void vm::typeChecker(Type *x, object::Object *y) {
   switch (x->kind()) {
@@ -103,8 +284,15 @@ void vm::typeChecker(Type *x, object::Object *y) {
 
     object::Array *arr = static_cast<object::Array *>(y);
 
-    for (auto i : arr->elements)
-      this->typeChecker(T->T, i);
+    // PACKED
+    object::Packed p = arr->storage();
+    if ((p == object::P_INT && T->T->kind() == T_INT) ||
+        (p == object::P_FLOAT && T->T->kind() == T_FLOAT) ||
+        (p == object::P_CHAR && T->T->kind() == T_CHAR))
+      break;
+
+    for (int i = 0; i < arr->size(); i++)
+      this->typeChecker(T->T, arr->at(i));
     break;
   }
   // tuple
@@ -135,6 +323,16 @@ void vm::typeChecker(Type *x, object::Object *y) {
     }
     break;
   }
+  // generator
+  case T_GEN:
+    if (y->kind() != object::GEN)
+      error("type error not found generator");
+    break;
+  // channel
+  case T_CHAN:
+    if (y->kind() != object::CHAN)
+      error("type error not found channel");
+    break;
   // func
   case T_FUNC: {
     Func *T = static_cast<Func *>(x);
@@ -278,78 +476,6 @@ object::Object *vm::setOriginalValue(Type *t) {
   return nullptr;
 }
 
-// add counter for bytecode within jump
-void vm::addCounter(int *ip, int to) {
-  bool reverse = *ip > to; // condition
-  // std::cout << "JUMP: " << *ip << " TO: " << to << std::endl;
-
-  if (reverse)
-    (*ip)--; // reverse skip current instruction
-
-  while (
-      /*
-       * condition
-       *
-       * reversal needs to be judged by the jump instruction itself,
-       * so its greater than or equal to
-       *
-       * forward, until the judgement instruction itself,
-       * do not do its own offset
-       *
-       * forward, it processes its own offset
-       */
-      (reverse ? *ip >= to : *ip < to)
-      //
-  ) {
-    switch (top()->entity->codes.at(*ip)) {
-      // offset of instruction processing
-    case byte::LOAD:   // 1
-    case byte::CONST:  // 1
-    case byte::ASSIGN: // 1
-    case byte::JUMP:   // 1
-    case byte::T_JUMP: // 1
-    case byte::F_JUMP: // 1
-    case byte::CALL:   // 1
-    case byte::GET:    // 1
-    case byte::SET:    // 1
-    case byte::WHOLE:  // 1
-    case byte::FUNC:   // 1
-    case byte::NAME:   // 1
-    case byte::ENUM:   // 1
-    case byte::MOD:    // 1
-    case byte::USE:    // 1
-    {
-      if (reverse) {
-        // ADD
-        this->op -= 1;
-      } else {
-        // MINUS
-        this->op += 1;
-      }
-      break;
-    }
-    case byte::STORE: // 2
-    case byte::NEW:   // 2
-    {
-      if (reverse) {
-        // ADD TWO
-        this->op -= 2;
-      } else {
-        // MINUS TWO
-        this->op += 2;
-      }
-      break;
-    }
-    }
-    // indexes
-    reverse ? (*ip)-- : (*ip)++;
-  }
-
-  // std::cout << "OP: " << this->op << " IP: " << *ip << "+1" << std::endl;
-  if (!reverse)
-    (*ip)--; // for loop update
-}
-
 // to execute the whole
 void vm::newWhole(std::string name, int count, bool inner) {
   // std::cout << "NEW: " << name << std::endl;
@@ -359,25 +485,20 @@ void vm::newWhole(std::string name, int count, bool inner) {
   if (obj == nullptr || obj->kind() != object::WHOLE)
     error("not defined whole of '" + name + "'");
 
-  int size = sizeof(object::Whole); // 112
-                                    // std::cout << size << std::endl;
-
   object::Whole *r = static_cast<object::Whole *>(obj);
-  object::Whole *w = (object::Whole *)malloc(size);
-
-  memcpy(w, r, size); // MEM COPY
-  // std::cout << "N: " << w << " <- " << r << std::endl;
 
   // EVALUATE IT
-  w->f = new Frame(w->entity);
+  Frame *f = new Frame(r->entity);
 
-  int t = this->op; // TEMP OFFSET
-
-  this->op = 0;
-  this->frames.push_back(w->f); // GO
+  this->pushFrame(f); // GO
   this->evaluate();
 
-  this->frames.pop_back(); // POP
+  this->popFrame(); // POP
+
+  // COPY, AFTER EVALUATING AS IT IS NOT A ROOT OF COLLECTOR
+  object::Whole *w = new object::Whole(*r);
+  // std::cout << "N: " << w << " <- " << r << std::endl;
+  w->f = f;
 
   // SET CONSTRUCTOR
   while (count > 0) {
@@ -405,8 +526,7 @@ void vm::newWhole(std::string name, int count, bool inner) {
 
   w->newOut = true; // TO NEW
 
-  PUSH(w);                    // PUSH
-  this->op = inner ? t : ++t; // NEXT
+  PUSH(w); // PUSH
 }
 
 // to check interface of whole
@@ -463,405 +583,1614 @@ void vm::checkInterface(object::Whole *src, object::Whole *dst) {
   }
 }
 
-void vm::evaluate() { // EVALUATE
+// mark objects of value stack, frames, and modules or function of task
+void vm::roots() {
+  for (int i = 0; i < this->stack.len(); i++)
+    gc::shade(this->stack.at(i));
+  for (auto i : this->frames)
+    gc::mark(i);
+  gc::shade(this->callWhole);
+
+  if (this->own == nullptr) {
+    for (auto i : *this->mods)
+      gc::shade(i);
+    return;
+  }
+  gc::shade(this->own->func); // MODULES ARE OF PROGRAM, NOT OF TASK
+  for (auto i : this->own->args)
+    gc::shade(i);
+}
 
-#define BINARY_OP(T, L, OP, R) PUSH(new T(L OP R));
+// run generator to its next yield, nullptr if it returned
+object::Object *vm::resume(object::Gen *g) {
+  Frame *f = g->frame;
+  if (f == nullptr)
+    return nullptr; // RETURNED
+  if (!object::owned(g))
+    error("parallel loop resumes shared generator");
 
-  for (int ip = 0; ip < top()->entity->codes.size(); ip++) { // MAIN LOOP
+  this->pushFrame(f); // RESUME
+  this->evaluate();
+  this->popFrame();
+  gc::write(g); // ITS FRAME IS WRITTEN
+
+  object::Object *obj = top()->ret; // YIELDED
+  top()->ret = nullptr;
+  this->loopWasRet = false;
+
+  if (f->ip == 0) {
+    g->frame = nullptr;
+    f->drop();
+    this->pool.push_back(f); // REUSE
+    return nullptr;
+  }
+  if (g->func->ret != nullptr)
+    this->typeChecker(g->func->ret, obj); // TYPE CHECKER
+  return obj;
+}
 
-    this->lp = ip;
+// call a function of main frame with arguments in order, its return value
+object::Object *vm::call(const std::string &name,
+                         std::vector<object::Object *> &args) {
+  object::Object *obj = this->lookUpMainFrame(name);
+  if (obj == nullptr || obj->kind() != object::FUNC)
+    error("not defined function '" + name + "'");
 
-    // bytecode
-    byte::Code co = top()->entity->codes.at(ip);
+  return this->invoke(static_cast<object::Func *>(obj), args);
+}
 
-    switch (co) {
-    case byte::CONST: { // CONST
-      object::Object *obj = this->retConstant();
+// call a function with arguments in order on the top, its return value
+object::Object *vm::invoke(object::Func *f,
+                           std::vector<object::Object *> &args) {
+  if (f->arguments.size() != args.size())
+    error("wrong number of parameters");
 
-      this->op++;
+  Frame *fra = this->newFrame(f->entity);
+  fra->tb.parent = &main()->tb;
 
-      // STRING TEMPLATE
-      if (obj->kind() == object::STR) {
-        object::Str *s = static_cast<object::Str *>(obj);
+  auto val = args.begin();
+  for (auto &i : f->arguments) {
+    this->typeChecker(i.second, *val); // TYPE CHECKER
+    fra->tb.emit(i.first->literal, *val++);
+  }
 
-        char *data = s->value.data(); // CHARS
-        int count = 0;                // COUNT
+  if (f->gen) {
+    fra->gen = true;
+    return new object::Gen(f, fra); // SUSPENDED UNTIL ITERATED
+  }
 
-        while (*data++ != '\0')
-          if (*data == '$')
-            count++; // GET COUNT OF $
+  size_t depth = this->frames.size();
+  try {
+    this->pushFrame(fra);
+    this->evaluate();
+  } catch (exp::Exp &) {
+    // UNWIND, the vm goes on with the next call
+    while (this->frames.size() > depth)
+      this->popFrame();
+    main()->ret = nullptr;
+    this->callWholeMethod = false;
+    this->callWhole = nullptr;
+    this->loopWasRet = this->local = false;
+    throw;
+  }
+  this->popFrame();
 
-        if (count == 0) { // NONE
-          PUSH(obj);
-          break;
-        }
+  fra->drop();
+  this->pool.push_back(fra); // REUSE
 
-        object::Str *n = new object::Str(s->value); // NEW
+  object::Object *obj = main()->ret;
+  main()->ret = nullptr;
+  this->loopWasRet = false;
 
-        while (count-- > 0) {
+  if (f->ret != nullptr) {
+    if (obj == nullptr)
+      error("missing return value");
+    this->typeChecker(f->ret, obj); // TYPE CHECKER
+  }
+  return obj;
+}
 
-          for (int i = 0; i < n->value.size(); i++) {
-            if (n->value.at(i) == '$') {
-              i++; // SKIP LEFT $
+// names of builtin functions of descriptors, the task awaits them
+static const char *ioNames[] = {"ioListen", "ioAccept", "ioConnect", "ioPort",
+                                "ioRead",   "ioWrite",  "ioOpen",    "ioPipe",
+                                "ioClose",  "httpServe"};
 
-              // TO NAME
-              std::string r;
+static bool isIoName(const std::string &name) {
+  return std::find(std::begin(ioNames), std::end(ioNames), name) !=
+         std::end(ioNames);
+}
 
-              // GET NAME
-              while (i < n->value.size() && isalpha(n->value.at(i))) {
-                r.push_back(n->value.at(i));
-                i++;
-              }
+// names of builtin functions of tasks, called by vm
+static bool isTaskName(const std::string &name) {
+  return name == "spawn" || name == "chan" || name == "send" ||
+         name == "recv" || name == "sleep" || isIoName(name);
+}
 
-              if (r.empty())
-                error("string template need a ident name");
-              object::Object *o = this->lookUp(r); // OBJECT
+// a thread of tasks, one of each core
+struct Core {
+  ucontext_t home;          // REGISTERS OF ITS LOOP WHILE A TASK RUNS
+  std::deque<Task *> ready; // TO RUN IN ORDER
+  Task *running = nullptr;
+};
 
-              if (o == nullptr)
-                error("not defined name '" + r + "'");
+// thread of tasks of current thread, none of others
+static thread_local Core *here = nullptr;
 
-              int p = i - r.size() - 1; // START
+// thread of running task, read again after each switch as the task may go
+// on on another thread
+__attribute__((noinline)) static Core *core() { return here; }
 
-              n->value.erase(p, r.size() + 1);   // REMOVE
-              n->value.insert(p, o->stringer()); // INSERT
+// threads of tasks, timers and awaited descriptors of process, made at first
+// and never ended, shared by the tasks of all runtimes
+//
+// each thread runs the tasks of its queue, an idle one steals half of the
+// longest queue of others, so that the tasks of a program run on all cores,
+// a task woken by another one is queued on the thread of waker
+//
+// all of it is guarded by one lock, the channels have locks of their own
+// which are taken before it
+class Scheduler {
+  std::vector<Core *> cores;
+  int idle = 0;    // threads waiting for tasks
+  size_t next = 0; // queue of tasks woken out of threads of tasks
+
+  std::condition_variable more; // OF IDLE THREADS
+
+  int epoll = -1;        // OF AWAITED DESCRIPTORS
+  int signal = -1;       // NEW TIMER, TO POLLER
+  bool polling = false;  // POLLER IS MADE
+
+  // run tasks of its queue or stolen ones until the end of process, free
+  // each of them as it returns
+  void loop(Core *c) {
+    here = c;
+    std::unique_lock<std::mutex> l(m);
+    for (;;) {
+      Task *t = this->take(c);
+      if (t == nullptr) {
+        this->idle++;
+        this->more.wait(l);
+        this->idle--;
+        continue;
+      }
+      c->running = t;
+      l.unlock();
+      {
+        gc::Scope scope(t->heap.get());
+        swapcontext(&c->home, &t->context);
+      }
+      l.lock();
+      c->running = nullptr;
+
+      if (t->done) {
+        Group *g = t->group;
+        g->tasks.erase(std::find(g->tasks.begin(), g->tasks.end(), t));
+        if (g->tasks.empty() || g->stuck())
+          g->woken.notify_one();
+        l.unlock();
+        delete t->v; // ITS FRAMES, THEN ITS OBJECTS AND C STACK
+        delete t;
+        l.lock();
+        continue;
+      }
+      t->parked = true; // REGISTERS ARE SAVED
+      if (!t->blocked) {
+        t->parked = false; // WOKEN AS IT WAS SWITCHING
+        c->ready.push_back(t);
+      }
+    }
+  }
 
-              break; // NEXT
-            }
-          }
+  // first task of queue of thread, or of the stolen half of the longest
+  // queue of others, the newest ones
+  Task *take(Core *c) {
+    if (c->ready.empty()) {
+      Core *v = nullptr;
+      for (auto i : this->cores)
+        if (i != c && (v == nullptr || i->ready.size() > v->ready.size()))
+          v = i;
+      if (v == nullptr || v->ready.empty())
+        return nullptr;
+
+      size_t n = (v->ready.size() + 1) / 2;
+      c->ready.insert(c->ready.end(), v->ready.end() - n, v->ready.end());
+      v->ready.erase(v->ready.end() - n, v->ready.end());
+    }
+    Task *t = c->ready.front();
+    c->ready.pop_front();
+    return t;
+  }
+
+  // wake tasks of timers and of ready descriptors, on a thread of its own
+  void poll() {
+    epoll_event events[64];
+    std::unique_lock<std::mutex> l(m);
+    for (;;) {
+      int ms = -1; // NO TIMER, UNTIL A DESCRIPTOR OR NEW TIMER
+      if (!this->sleeping.empty()) {
+        auto first = std::min_element(
+            this->sleeping.begin(), this->sleeping.end(),
+            [](Task *a, Task *b) { return a->wake < b->wake; });
+        auto d = (*first)->wake - std::chrono::steady_clock::now();
+        ms = std::max<long>(
+            0, std::chrono::ceil<std::chrono::milliseconds>(d).count());
+      }
+      l.unlock();
+      int n = epoll_wait(this->epoll, events, 64, ms);
+      l.lock();
+
+      for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == this->signal) {
+          uint64_t k;
+          read(this->signal, &k, sizeof(k));
+          continue;
         }
+        auto it = this->watches.find(events[i].data.fd);
+        if (it == this->watches.end())
+          continue; // CLOSED
+        Watch &w = it->second;
+
+        uint32_t e = events[i].events;
+        bool hup = e & (EPOLLERR | EPOLLHUP); // WOKEN TO SEE THE ERROR
+        for (auto t : {&w.reader, &w.writer})
+          if (*t != nullptr &&
+              (e & (t == &w.reader ? EPOLLIN : EPOLLOUT) || hup)) {
+            (*t)->group->awaiting--;
+            this->wake(*t);
+            *t = nullptr;
+          }
+        if (w.reader != nullptr || w.writer != nullptr)
+          this->arm(it->first, w); // ONE SHOT, THE OTHER ONE STILL AWAITS
+      }
 
-        PUSH(n);
-        break;
+      auto now = std::chrono::steady_clock::now();
+      auto due = std::stable_partition(
+          this->sleeping.begin(), this->sleeping.end(),
+          [now](Task *t) { return t->wake > now; });
+      for (auto i = due; i != this->sleeping.end(); i++) {
+        (*i)->group->timed--;
+        this->wake(*i);
       }
+      this->sleeping.erase(due, this->sleeping.end());
+    }
+  }
 
-      PUSH(obj);
-    } break;
+public:
+  std::mutex m;
 
-      //
-      // BINARY OPERATOR START
-      //
+  std::vector<Task *> sleeping; // BLOCKED BY TIMER
+  std::map<int, Watch> watches; // TASKS AWAITING EACH DESCRIPTOR
 
-    case byte::ADD: { // +
-      object::Object *y = POP();
-      object::Object *x = POP();
+  explicit Scheduler(int n) {
+    this->epoll = epoll_create1(EPOLL_CLOEXEC);
+    this->signal = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = this->signal;
+    epoll_ctl(this->epoll, EPOLL_CTL_ADD, this->signal, &ev);
 
-      // <Int> + <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Int, static_cast<object::Int *>(x)->value, +,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Float, static_cast<object::Int *>(x)->value, +,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
-      }
-      // <Float> + <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, +,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, +,
-                    static_cast<object::Float *>(y)->value);
-          break;
+    for (int i = 0; i < n; i++)
+      this->cores.push_back(new Core);
+    for (auto c : this->cores)
+      std::thread([this, c] { this->loop(c); }).detach();
+  }
+
+  // ready task to queue of this thread, or of the next one out of threads
+  // of tasks, an idle thread is woken to steal it
+  void push(Task *t) {
+    Core *c = core();
+    if (c == nullptr)
+      c = this->cores.at(this->next++ % this->cores.size());
+    c->ready.push_back(t);
+    if (this->idle > 0)
+      this->more.notify_one();
+  }
+
+  // blocked task to ready, the main one is woken on its thread
+  void wake(Task *t) {
+    if (!t->blocked)
+      return;
+    t->blocked = false;
+
+    Group *g = t->group;
+    if (t == &g->main) {
+      g->woken.notify_one();
+      return;
+    }
+    g->active++;
+    if (t->parked) {
+      t->parked = false;
+      this->push(t);
+    }
+  }
+
+  // blocked task out of timers and descriptors, as it is woken by other
+  void forget(Task *t) {
+    auto i = std::find(this->sleeping.begin(), this->sleeping.end(), t);
+    if (i != this->sleeping.end()) {
+      this->sleeping.erase(i);
+      t->group->timed--;
+    }
+    for (auto &i : this->watches)
+      for (auto w : {&i.second.reader, &i.second.writer})
+        if (*w == t) {
+          *w = nullptr;
+          t->group->awaiting--;
         }
+  }
+
+  // tasks of group are ended, the running ones at their next safe point and
+  // the blocked ones as they are woken
+  void cancel(Group *g) {
+    g->stop = true;
+    for (auto t : g->tasks) {
+      t->heap->pending = true;
+      if (t->blocked) {
+        this->forget(t);
+        this->wake(t);
       }
-      // <Str> + <Str>
-      else if (x->kind() == object::STR && y->kind() == object::STR) {
-        object::Str *l = static_cast<object::Str *>(x);
-        object::Str *r = static_cast<object::Str *>(y);
+    }
+  }
 
-        if (l->longer || r->longer)
-          error("cannot plus long string literal");
+  // events of awaited descriptor, false if it can not be awaited
+  bool arm(int fd, Watch &w) {
+    epoll_event ev{};
+    ev.events = EPOLLONESHOT | (w.reader != nullptr ? EPOLLIN : 0) |
+                (w.writer != nullptr ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+
+    if (w.added && epoll_ctl(this->epoll, EPOLL_CTL_MOD, fd, &ev) == 0)
+      return true;
+    if (epoll_ctl(this->epoll, EPOLL_CTL_ADD, fd, &ev) != 0)
+      return false; // REGULAR FILE IS ALWAYS READY
+    w.added = true;
+    return true;
+  }
 
-        PUSH(new object::Str(l->value + r->value));
-      } else {
-        // ERROR
-        error("unsupport type to + operator");
-      }
-    } break;
+  // poller made at first, then told of a new timer
+  void timer() {
+    if (!this->polling) {
+      this->polling = true;
+      std::thread([this] { this->poll(); }).detach();
+    }
+    uint64_t k = 1;
+    write(this->signal, &k, sizeof(k));
+  }
+};
 
-    case byte::SUB: { // -
-      object::Object *y = POP();
-      object::Object *x = POP();
+// scheduler of process, a thread of each core
+static Scheduler *scheduler() {
+  static Scheduler *s =
+      new Scheduler(std::max(1u, std::thread::hardware_concurrency()));
+  return s;
+}
 
-      // <Int> - <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Int, static_cast<object::Int *>(x)->value, -,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Float, static_cast<object::Int *>(x)->value, -,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
+vm::~vm() {
+  if (this->group != nullptr) {
+    this->end(); // ITS TASKS REFER NOTHING OF IT
+    delete this->group;
+  }
+
+  // ITS FRAMES, THOSE OF GENERATORS ARE FREED BY THEM
+  if (this->worker || this->own != nullptr) {
+    for (auto i : this->frames)
+      if (!i->gen)
+        delete i;
+    for (auto i : this->pool)
+      delete i;
+  }
+}
+
+// running task, the main one is made at first
+Task *vm::self() {
+  if (this->own != nullptr)
+    return this->own;
+  if (this->group == nullptr) {
+    this->group = new Group;
+    this->group->main.group = this->group;
+  }
+  return &this->group->main;
+}
+
+// block running task until it is woken, it is blocked before the lock of
+// what it awaits is released so that no waker misses it
+void vm::park(std::unique_lock<std::mutex> &l) {
+  Scheduler *s = scheduler();
+  Task *t = this->self();
+  Group *g = t->group;
+
+  std::unique_lock<std::mutex> k;
+  if (l.mutex() == &s->m)
+    k = std::move(l);
+  else
+    k = std::unique_lock<std::mutex>(s->m);
+  t->blocked = true;
+  if (l.owns_lock())
+    l.unlock();
+
+  // MAIN TASK ON ITS THREAD, UNTIL WOKEN OR ERROR OF A TASK OR NONE GOES ON
+  if (this->own == nullptr) {
+    g->woken.wait(k, [g, t] {
+      return !t->blocked || g->failure != nullptr || g->stuck();
+    });
+    if (!t->blocked)
+      return;
+    t->blocked = false;
+    s->forget(t);
+
+    std::exception_ptr e = g->failure;
+    g->failure = nullptr;
+    k.unlock();
+    if (e != nullptr)
+      std::rethrow_exception(e);
+    error("all tasks are blocked");
+  }
+
+  g->active--;
+  if (g->stuck())
+    g->woken.notify_one();
+  k.unlock();
+
+  swapcontext(&t->context, &core()->home);
+  // RESUMED, MAYBE ON ANOTHER THREAD
+  if (g->stop)
+    error("task is ended");
+}
+
+// first blocked one of queue of channel, others were woken to end
+void vm::wakeOne(std::deque<Task *> &q) {
+  Scheduler *s = scheduler();
+  std::lock_guard<std::mutex> l(s->m);
+  while (!q.empty()) {
+    Task *t = q.front();
+    q.pop_front();
+    if (t->blocked) {
+      s->wake(t);
+      return;
+    }
+  }
+}
+
+// block running task until descriptor is readable or writable, false if it
+// is always ready
+bool vm::await(int fd, bool write) {
+  Scheduler *s = scheduler();
+  std::unique_lock<std::mutex> l(s->m);
+
+  Watch &w = s->watches[fd];
+  Task *&t = write ? w.writer : w.reader;
+  if (t != nullptr)
+    error("descriptor is awaited by another task");
+
+  t = this->self();
+  if (!s->arm(fd, w)) {
+    t = nullptr;
+    return false;
+  }
+  this->self()->group->awaiting++;
+  s->timer(); // POLLER IS MADE
+  this->park(l);
+  return true;
+}
+
+// write all bytes, the running task awaits descriptor while it is full,
+// false by error
+bool vm::flush(int fd, const char *p, size_t n) {
+  for (size_t done = 0; done < n;) {
+    ssize_t k = send(fd, p + done, n - done,
+                     MSG_NOSIGNAL); // NOT TO BE KILLED BY CLOSED PEER
+    if (k < 0 && errno == ENOTSOCK)
+      k = write(fd, p + done, n - done);
+    if (k >= 0) {
+      done += k;
+      continue;
+    }
+    if (errno == EINTR)
+      continue;
+    if ((errno != EAGAIN && errno != EWOULDBLOCK) || !this->await(fd, true))
+      return false;
+  }
+  return true;
+}
+
+// status of response of map returned by handler, its header fields, and
+// :status and :body pseudo fields, or 500 and the error as body
+static int reply(object::Map *m, std::string *body, http::Fields *fields) {
+  int status = 200;
+  for (auto &i : m->elements) {
+    if (i.first->kind() != object::STR || i.second->kind() != object::STR) {
+      *body = "fields of response are not strings";
+      fields->clear();
+      return 500;
+    }
+    const std::string &k = static_cast<object::Str *>(i.first)->value;
+    const std::string &v = static_cast<object::Str *>(i.second)->value;
+
+    if (k == ":body") {
+      *body = v;
+    } else if (k == ":status") {
+      status = v.size() == 3 && std::isdigit((unsigned char)v[0]) &&
+                       std::isdigit((unsigned char)v[1]) &&
+                       std::isdigit((unsigned char)v[2])
+                   ? std::stoi(v)
+                   : 0;
+      if (status < 100) {
+        *body = "invalid status '" + v + "'";
+        fields->clear();
+        return 500;
       }
-      // <Float> - <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, -,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, -,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
-      } else {
-        // ERROR
-        error("unsupport type to - operator");
+    } else if (k.empty() || k.front() == ':' ||
+               k.find_first_of(" \t\r\n:") != std::string::npos ||
+               v.find_first_of("\r\n") != std::string::npos) {
+      *body = "invalid field '" + k + "'"; // NO SPLITTING OF RESPONSE
+      fields->clear();
+      return 500;
+    } else {
+      fields->emplace_back(k, v);
+    }
+  }
+  return status;
+}
+
+// serve requests of HTTP connection of task by its function, responses of
+// pipelined ones are written at once in order
+void vm::connection(Task *t) {
+  int fd = t->conn;
+  std::string in(http::buffer, '\0'); // OF CONNECTION, ALL OF ITS REQUESTS
+  std::string out;
+  out.reserve(http::buffer);
+
+  http::Request r;
+  size_t used = 0;
+
+  for (bool open = true; open;) {
+    ssize_t n = read(fd, in.data() + used, in.size() - used);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+        this->await(fd, false))
+      continue;
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break; // CLOSED BY PEER OR ERROR
+    used += n;
+
+    size_t at = 0;
+    while (open) {
+      int k = http::parse(std::string_view(in.data() + at, used - at), &r);
+      if (k == 0 && (at > 0 || used < in.size()))
+        break; // REST IS NOT READ
+      if (k <= 0) {
+        http::respond(out, k == 0 ? 413 : k == -1 ? 400 : 501, "", false);
+        open = false;
+        break;
       }
-    } break;
+      at += k;
+
+      object::Map *h = new object::Map;
+      for (auto &i : r.headers) {
+        std::string name(i.first);
+        for (auto &c : name)
+          c = std::tolower((unsigned char)c);
+        object::Object *key = new object::Str(name);
+        object::Object *val = new object::Str(std::string(i.second));
+        h->elements.insert(std::make_pair(key, val));
+        object::hold(key);
+        object::hold(val);
+      }
+      std::vector<object::Object *> args = {
+          new object::Str(std::string(r.method)),
+          new object::Str(std::string(r.path)), h,
+          new object::Str(std::string(r.body))};
+
+      int status = 200;
+      std::string body;
+      http::Fields fields;
+      try {
+        object::Object *obj = this->invoke(t->func, args);
+        if (obj != nullptr && obj->kind() == object::MAP)
+          status = reply(static_cast<object::Map *>(obj), &body, &fields);
+        else if (obj != nullptr)
+          body = obj->kind() == object::STR
+                     ? static_cast<object::Str *>(obj)->value
+                     : obj->stringer();
+      } catch (exp::Exp &e) {
+        if (t->group->stop)
+          throw; // ENDED WITH PROGRAM
+        status = 500; // THE SERVER GOES ON
+        body = e.stringer();
+      }
+      http::respond(out, status, body, r.keep, fields, r.old);
+      open = r.keep;
+    }
+    std::memmove(in.data(), in.data() + at, used - at); // REST TO FRONT
+    used -= at;
 
-    case byte::MUL: { // *
-      object::Object *y = POP();
-      object::Object *x = POP();
+    if (!this->flush(fd, out.data(), out.size()))
+      break;
+    out.clear();
+  }
+  std::lock_guard<std::mutex> l(scheduler()->m);
+  scheduler()->watches.erase(fd);
+  close(fd);
+}
 
-      // <Int> * <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Int, static_cast<object::Int *>(x)->value, *,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Float, static_cast<object::Int *>(x)->value, *,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
+// IPV4 address of dotted string and port
+static bool address(const std::string &host, int port, sockaddr_in *a) {
+  *a = sockaddr_in{};
+  a->sin_family = AF_INET;
+  a->sin_port = htons(port);
+  return inet_pton(AF_INET, host.c_str(), &a->sin_addr) == 1;
+}
+
+// builtin of descriptors, arguments in order, the running task is blocked
+// until the descriptor is ready, descriptors are non blocking
+object::Object *vm::ioCall(const std::string &name,
+                           std::vector<object::Object *> &args) {
+  // ARGUMENTS OF KINDS
+  auto want = [&](std::vector<object::Kind> k, const std::string &of) {
+    bool ok = args.size() == k.size();
+    for (int i = 0; ok && i < k.size(); i++)
+      ok = args.at(i)->kind() == k.at(i);
+    if (!ok)
+      error("the <" + name + "> function receives " + of);
+  };
+  auto fail = [&]() {
+    error("the <" + name + "> function fails: " + std::strerror(errno));
+  };
+  auto integer = [&](int i) {
+    return static_cast<object::Int *>(args.at(i))->value;
+  };
+  auto string = [&](int i) {
+    return static_cast<object::Str *>(args.at(i))->value;
+  };
+
+  // LISTEN
+  if (name == "ioListen") {
+    want({object::STR, object::INT}, "an address and a port");
+    sockaddr_in a;
+    if (!address(string(0), integer(1), &a))
+      error("invalid address '" + string(0) + "'");
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (fd < 0 || bind(fd, (sockaddr *)&a, sizeof(a)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+      int e = errno;
+      close(fd);
+      errno = e;
+      fail();
+    }
+    return new object::Int(fd);
+  }
+  // SERVE, UNTIL LISTENING SOCKET IS CLOSED
+  if (name == "httpServe") {
+    want({object::INT, object::FUNC}, "a listening socket and a handler");
+    object::Func *h = static_cast<object::Func *>(args.at(1));
+    if (isBuiltinName(h->name) || isTaskName(h->name) ||
+        h->arguments.size() != 4)
+      error("the <httpServe> handler receives method, path, headers and "
+            "body");
+
+    while (true) {
+      int fd = accept4(integer(0), nullptr, nullptr,
+                       SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd >= 0) {
+        std::vector<object::Object *> none;
+        this->start(h, none, fd); // A TASK OF EACH CONNECTION
+        continue;
       }
-      // <Float> * <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, *,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, *,
-                    static_cast<object::Float *>(y)->value);
-          break;
+      if (errno == EBADF || errno == EINVAL)
+        return nullptr; // CLOSED
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      if ((errno != EAGAIN && errno != EWOULDBLOCK) ||
+          !this->await(integer(0), false))
+        fail();
+    }
+  }
+  // CONNECT
+  if (name == "ioConnect") {
+    want({object::STR, object::INT}, "an address and a port");
+    sockaddr_in a;
+    if (!address(string(0), integer(1), &a))
+      error("invalid address '" + string(0) + "'");
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+      fail();
+    int e = 0;
+    if (connect(fd, (sockaddr *)&a, sizeof(a)) != 0) {
+      e = errno;
+      if (e == EINPROGRESS) { // ONCE IT IS WRITABLE
+        this->await(fd, true);
+
+        socklen_t n = sizeof(e);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &e, &n);
+      }
+    }
+    if (e != 0) {
+      {
+        std::lock_guard<std::mutex> l(scheduler()->m);
+        scheduler()->watches.erase(fd);
+        close(fd);
+      }
+      errno = e;
+      fail();
+    }
+    return new object::Int(fd);
+  }
+  // CLOSE
+  if (name == "ioClose") {
+    want({object::INT}, "a descriptor");
+    int fd = integer(0);
+
+    Scheduler *s = scheduler();
+    std::unique_lock<std::mutex> l(s->m);
+    auto it = s->watches.find(fd);
+    if (it != s->watches.end()) {
+      for (auto t : {it->second.reader, it->second.writer})
+        if (t != nullptr) { // TO SEE IT IS CLOSED
+          t->group->awaiting--;
+          s->wake(t);
         }
-      } else {
-        // ERROR
-        error("unsupport type to * operator");
+      s->watches.erase(it);
+    }
+    if (close(fd) != 0) // UNDER LOCK, NO TASK AWAITS IT AGAIN BEFORE
+      fail();
+    return nullptr;
+  }
+  // PORT
+  if (name == "ioPort") {
+    want({object::INT}, "a descriptor");
+    sockaddr_in a;
+    socklen_t n = sizeof(a);
+    if (getsockname(integer(0), (sockaddr *)&a, &n) != 0)
+      fail();
+    return new object::Int(ntohs(a.sin_port));
+  }
+  // OPEN
+  if (name == "ioOpen") {
+    want({object::STR, object::STR}, "a path and a mode of r, w or a");
+    std::string mode = string(1);
+
+    int flags = O_NONBLOCK | O_CLOEXEC;
+    if (mode == "r")
+      flags |= O_RDONLY;
+    else if (mode == "w")
+      flags |= O_WRONLY | O_CREAT | O_TRUNC;
+    else if (mode == "a")
+      flags |= O_WRONLY | O_CREAT | O_APPEND;
+    else
+      error("the <" + name + "> function receives a path and a mode of r, "
+            "w or a");
+
+    int fd = open(string(0).c_str(), flags, 0644);
+    if (fd < 0)
+      fail();
+    return new object::Int(fd);
+  }
+  // PIPE
+  if (name == "ioPipe") {
+    want({}, "no arguments");
+    int p[2];
+    if (pipe2(p, O_NONBLOCK | O_CLOEXEC) != 0)
+      fail();
+
+    object::Array *a = new object::Array;
+    a->packed = object::P_INT;
+    a->ints = {p[0], p[1]}; // TO READ AND TO WRITE
+    return a;
+  }
+  // ACCEPT
+  if (name == "ioAccept") {
+    want({object::INT}, "a descriptor");
+    while (true) {
+      int fd = accept4(integer(0), nullptr, nullptr,
+                       SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd >= 0)
+        return new object::Int(fd);
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        fail();
+      if (errno != EINTR && !this->await(integer(0), false))
+        fail();
+    }
+  }
+  // READ
+  if (name == "ioRead") {
+    want({object::INT, object::INT}, "a descriptor and a count");
+    std::string buf(std::max(0, integer(1)), '\0');
+    while (true) {
+      ssize_t n = read(integer(0), buf.data(), buf.size());
+      if (n >= 0) {
+        buf.resize(n); // EMPTY AT THE END
+        return new object::Str(buf);
       }
-    } break;
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        fail();
+      if (errno != EINTR && !this->await(integer(0), false))
+        fail();
+    }
+  }
+  // WRITE
+  want({object::INT, object::STR}, "a descriptor and a string");
+  const std::string &s = static_cast<object::Str *>(args.at(1))->value;
+  if (!this->flush(integer(0), s.data(), s.size()))
+    fail();
+  return new object::Int(s.size());
+}
 
-    case byte::DIV: { // /
-      object::Object *y = POP();
-      object::Object *x = POP();
+// entry of task on its C stack, its thread frees it as it returns
+void vm::launch() {
+  Task *t = core()->running;
+  vm *v = t->v;
+  try {
+    if (t->conn >= 0)
+      v->connection(t);
+    else
+      v->invoke(t->func, t->args);
+  } catch (exp::Exp &) {
+    Scheduler *s = scheduler();
+    std::lock_guard<std::mutex> l(s->m);
+    Group *g = t->group;
+    if (!g->stop) { // THE FIRST ERROR, OTHER TASKS ARE ENDED
+      g->failure = std::current_exception();
+      s->cancel(g);
+      g->woken.notify_one();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> l(scheduler()->m);
+    t->done = true;
+    t->group->active--;
+  }
+  setcontext(&core()->home); // NEVER RESUMED
+}
 
-      // <Int> / <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT: {
-          if (static_cast<object::Int *>(y)->value == 0)
-            error("division by zero");
-          BINARY_OP(object::Float, static_cast<object::Int *>(x)->value, /,
-                    static_cast<object::Int *>(y)->value);
-        } break;
-        //
-        case object::FLOAT: {
-          if (static_cast<object::Float *>(y)->value == 0)
-            error("division by zero");
-          BINARY_OP(object::Float, static_cast<object::Int *>(x)->value, /,
-                    static_cast<object::Float *>(y)->value);
-        } break;
-        }
-      }
-      // <Float> / <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT: {
-          if (static_cast<object::Int *>(y)->value == 0)
-            error("division by zero");
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, /,
-                    static_cast<object::Int *>(y)->value);
-        } break;
-        //
-        case object::FLOAT: {
-          if (static_cast<object::Float *>(y)->value == 0)
-            error("division by zero");
-          BINARY_OP(object::Float, static_cast<object::Float *>(x)->value, /,
-                    static_cast<object::Float *>(y)->value);
-        } break;
-        }
-      } else
-        // ERROR
-        error("unsupport type to / operator");
-    } break;
+// new task of function, its arguments and the names of program copied into
+// its heap, ready to run on any thread
+Task *vm::start(object::Func *f, std::vector<object::Object *> &args,
+                int conn) {
+  Task *t = new Task;
+  t->group = this->self()->group;
+  t->state = *this->state;
+  t->conn = conn;
+  t->mods = *this->mods; // ITS NAMES ARE COPIED AS THEY ARE USED
+
+  t->heap.reset(new gc::Heap);
+  t->heap->pause = this->heap->pause;
+  try {
+    gc::Scope into(t->heap.get());
+    std::map<object::Object *, object::Object *> done;
+
+    t->v = new vm(main()->entity, &t->mods, false, this->disMode, &t->state);
+    t->v->own = t;
+    for (auto &i : main()->tb.symbols)
+      t->v->main()->tb.emit(i.first, this->transfer(i.second, done));
+
+    t->func = static_cast<object::Func *>(this->transfer(f, done));
+    for (auto i : args)
+      t->args.push_back(this->transfer(i, done));
+  } catch (...) {
+    delete t->v;
+    delete t;
+    throw;
+  }
 
-    case byte::SUR: { // %
-      object::Object *y = POP();
-      object::Object *x = POP();
+  void *p = mmap(nullptr, taskGuard + taskStack, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1,
+                 0);
+  if (p == MAP_FAILED) {
+    delete t->v;
+    delete t;
+    error("no memory for C stack of task");
+  }
+  mprotect(p, taskGuard, PROT_NONE); // GUARD
+  t->cstack = static_cast<char *>(p) + taskGuard;
+
+  getcontext(&t->context);
+  t->context.uc_stack.ss_sp = t->cstack;
+  t->context.uc_stack.ss_size = taskStack;
+  t->context.uc_link = nullptr;
+  makecontext(&t->context, launch, 0);
+
+  Scheduler *s = scheduler();
+  std::lock_guard<std::mutex> l(s->m);
+  Group *g = t->group;
+  if (g->stop)
+    t->heap->pending = true; // ENDED AT ONCE
+  g->tasks.push_back(t);
+  g->active++;
+  s->push(t);
+  return t;
+}
 
-      // <Int> % <Int>
-      if (x->kind() == object::INT && y->kind() == object::INT) {
-        BINARY_OP(object::Int, static_cast<object::Int *>(x)->value, %,
-                  static_cast<object::Int *>(y)->value);
-      } else {
-        // ERROR
-        error("unsupport type to % operator");
+// object copied into current heap with all it refers, each one once, so
+// that names and elements referring one object refer one copy of it
+object::Object *
+vm::transfer(object::Object *o,
+             std::map<object::Object *, object::Object *> &done) {
+  if (o == nullptr || o->permanent)
+    return o; // COMPILED CONSTANTS
+  auto it = done.find(o);
+  if (it != done.end())
+    return it->second;
+
+  switch (o->kind()) {
+  case object::INT:
+    return done[o] = new object::Int(*static_cast<object::Int *>(o));
+  case object::FLOAT:
+    return done[o] = new object::Float(*static_cast<object::Float *>(o));
+  case object::STR:
+    return done[o] = new object::Str(*static_cast<object::Str *>(o));
+  case object::CHAR:
+    return done[o] = new object::Char(*static_cast<object::Char *>(o));
+  case object::BOOL:
+    return done[o] = new object::Bool(*static_cast<object::Bool *>(o));
+  case object::ENUM:
+    return done[o] = new object::Enum(*static_cast<object::Enum *>(o));
+  case object::FUNC:
+    return done[o] = new object::Func(*static_cast<object::Func *>(o));
+  case object::CHAN:
+    return done[o] = new object::Chan(static_cast<object::Chan *>(o)->q);
+  case object::ARRAY: {
+    object::Array *a = static_cast<object::Array *>(o);
+    object::Array *c = new object::Array;
+    done[o] = c;
+    if (a->storage() != object::P_OBJ) {
+      this->append(c, a, false); // PACKED
+      return c;
+    }
+    for (int i = 0; i < a->size(); i++) {
+      c->elements.push_back(this->transfer(a->at(i), done));
+      object::hold(c->elements.back());
+    }
+    return c;
+  }
+  case object::TUPLE: {
+    object::Tuple *c = new object::Tuple;
+    done[o] = c;
+    for (auto i : static_cast<object::Tuple *>(o)->elements) {
+      c->elements.push_back(this->transfer(i, done));
+      object::hold(c->elements.back());
+    }
+    return c;
+  }
+  case object::MAP: {
+    object::Map *c = new object::Map;
+    done[o] = c;
+    for (auto &i : static_cast<object::Map *>(o)->elements) {
+      object::Object *k = this->transfer(i.first, done);
+      object::Object *v = this->transfer(i.second, done);
+      c->elements.insert(std::make_pair(k, v));
+      object::hold(k);
+      object::hold(v);
+    }
+    return c;
+  }
+  case object::WHOLE: {
+    object::Whole *w = static_cast<object::Whole *>(o);
+    object::Whole *c = new object::Whole(*w);
+    c->f = nullptr;
+    done[o] = c;
+    if (w->f != nullptr) {
+      c->f = new Frame(w->f->entity);
+      for (auto &i : w->f->tb.symbols)
+        c->f->tb.emit(i.first, this->transfer(i.second, done));
+    }
+    return c;
+  }
+  default:
+    error("unsupport type to task");
+  }
+  return nullptr;
+}
+
+// builtin of tasks, arguments in order of stack, its return value or nullptr
+object::Object *vm::taskCall(const std::string &name,
+                             std::vector<object::Object *> &args) {
+  if (this->worker && name != "sleep")
+    error("tasks in parallel loop");
+  std::reverse(args.begin(), args.end()); // IN ORDER
+
+  if (isIoName(name))
+    return this->ioCall(name, args);
+
+  // SPAWN
+  if (name == "spawn") {
+    if (args.empty() || args.front()->kind() != object::FUNC ||
+        isBuiltinName(static_cast<object::Func *>(args.front())->name))
+      error("the <spawn> function receives a function and its arguments");
+    object::Func *f = static_cast<object::Func *>(args.front());
+
+    if (f->arguments.size() != args.size() - 1)
+      error("wrong number of parameters");
+
+    std::vector<object::Object *> rest(args.begin() + 1, args.end());
+    this->start(f, rest, -1);
+    return nullptr;
+  }
+  // CHAN
+  if (name == "chan") {
+    if (args.size() > 1 ||
+        (args.size() == 1 && args.front()->kind() != object::INT))
+      error("the <chan> function receives one <int> object or none");
+    int cap = 1;
+    if (args.size() == 1)
+      cap = std::max(1, static_cast<object::Int *>(args.front())->value);
+    return new object::Chan(cap);
+  }
+  // SEND AND RECV
+  if (name == "send" || name == "recv") {
+    if (args.size() != (name == "send" ? 2 : 1) ||
+        args.front()->kind() != object::CHAN)
+      error("the <" + name + "> function receives a channel" +
+            (name == "send" ? " and a value" : ""));
+    object::Chan::Queue *q = static_cast<object::Chan *>(args.front())->q.get();
+    std::unique_lock<std::mutex> l(q->m, std::defer_lock);
+
+    // BLOCKED IN QUEUE UNTIL WOKEN, OUT OF IT BY ERROR
+    auto wait = [&](std::deque<Task *> &w) {
+      Task *t = this->self();
+      w.push_back(t);
+      try {
+        this->park(l);
+      } catch (...) {
+        l.lock();
+        w.erase(std::remove(w.begin(), w.end(), t), w.end());
+        throw;
       }
-    } break;
+      l.lock();
+    };
+
+    if (name == "send") {
+      std::unique_ptr<gc::Heap> h(new gc::Heap); // OF VALUE, TO RECEIVER
+      object::Object *v;
+      {
+        gc::Scope into(h.get());
+        std::map<object::Object *, object::Object *> done;
+        v = this->transfer(args.back(), done);
+      }
+      l.lock();
+      while (q->buffer.size() >= q->cap)
+        wait(q->senders);
+      q->buffer.emplace_back(std::move(h), v);
 
-    case byte::GR: { // >
-      object::Object *y = POP();
-      object::Object *x = POP();
+      this->wakeOne(q->receivers);
+      return nullptr;
+    }
+    l.lock();
+    while (q->buffer.empty())
+      wait(q->receivers);
+    auto m = std::move(q->buffer.front());
+    q->buffer.pop_front();
+
+    this->wakeOne(q->senders);
+    l.unlock();
+    gc::adopt(m.first.get()); // ITS OBJECTS ARE OF RECEIVER
+    return m.second;
+  }
+  // SLEEP
+  if (args.size() != 1 || (args.front()->kind() != object::INT &&
+                           args.front()->kind() != object::FLOAT))
+    error("the <sleep> function receives one <int> or <float> object");
+  double n = args.front()->kind() == object::INT
+                 ? static_cast<object::Int *>(args.front())->value
+                 : static_cast<object::Float *>(args.front())->value;
+
+  auto d = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(n));
+  if (this->worker || (this->own == nullptr && this->group == nullptr)) {
+    std::this_thread::sleep_for(d); // NO OTHER TASKS
+    return nullptr;
+  }
+  Scheduler *s = scheduler();
+  std::unique_lock<std::mutex> l(s->m);
+  Task *t = this->self();
+  t->wake = std::chrono::steady_clock::now() + d;
+  s->sleeping.push_back(t);
+  t->group->timed++;
+  s->timer();
+  this->park(l);
+  return nullptr;
+}
 
-      // <Int> > <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, >,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, >,
-                    static_cast<object::Float *>(y)->value);
-          break;
+// wait for spawned tasks until none is ready, sleeping or awaiting, the
+// blocked ones are ended
+void vm::join() {
+  if (this->group == nullptr)
+    return;
+  Group *g = this->group;
+
+  std::unique_lock<std::mutex> l(scheduler()->m);
+  g->woken.wait(l, [g] {
+    return g->tasks.empty() || g->failure != nullptr || g->stuck();
+  });
+  std::exception_ptr e = g->failure;
+  g->failure = nullptr;
+  l.unlock();
+
+  this->end();
+  if (e != nullptr)
+    std::rethrow_exception(e);
+}
+
+// end tasks of program and wait for them, so that a failed or ended
+// program leaves none
+void vm::end() {
+  Group *g = this->group;
+  Scheduler *s = scheduler();
+
+  std::unique_lock<std::mutex> l(s->m);
+  s->cancel(g);
+  g->woken.wait(l, [g] { return g->tasks.empty(); });
+  g->stop = false;
+}
+
+// most iterations of parallel loop taken at a time
+constexpr int grainMost = 16 * 1024;
+constexpr int grainEach = 8; // chunks of each thread, fewer of short loops
+
+// threads running chunks of parallel loops, made at first and never ended,
+// so that the next loops reuse them and their caches of allocator
+class Pool {
+  std::mutex m;
+  std::condition_variable more;
+  std::deque<std::function<void()>> jobs;
+
+  void loop() {
+    for (;;) {
+      std::unique_lock<std::mutex> l(m);
+      more.wait(l, [this] { return !jobs.empty(); });
+      std::function<void()> f = std::move(jobs.front());
+      jobs.pop_front();
+      l.unlock();
+      f();
+    }
+  }
+
+public:
+  const int size; // threads of pool, besides the one of loop
+
+  explicit Pool(int n) : size(n) {
+    for (int i = 0; i < n; i++)
+      std::thread([this] { this->loop(); }).detach();
+  }
+
+  // run on the first idle thread
+  void submit(std::function<void()> f) {
+    {
+      std::lock_guard<std::mutex> l(m);
+      jobs.push_back(std::move(f));
+    }
+    more.notify_one();
+  }
+};
+
+// pool of process, shared by runtimes and never freed
+static Pool *workers() {
+  static Pool *p =
+      new Pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+  return p;
+}
+
+// identity of + reduction, of the kind of value before loop
+static object::Object *identity(object::Object *o) {
+  switch (o->kind()) {
+  case object::INT:
+    return new object::Int(0);
+  case object::FLOAT:
+    return new object::Float(0);
+  case object::STR:
+    return new object::Str("");
+  default:
+    return new object::Array;
+  }
+}
+
+// elements of array appended to the other one, which is not a view, packed
+// ones stay packed
+void vm::append(object::Array *dst, object::Array *src, bool deep) {
+  object::Array *s = src->view != nullptr ? src->view : src;
+  int from = src->view != nullptr ? src->from : 0;
+  int n = src->size();
+
+  if (dst->size() == 0)
+    dst->packed = s->packed; // HOLDS NOTHING
+  if (dst->packed == s->packed)
+    switch (s->packed) {
+    case object::P_INT:
+      dst->ints.insert(dst->ints.end(), s->ints.begin() + from,
+                       s->ints.begin() + from + n);
+      return;
+    case object::P_FLOAT:
+      dst->floats.insert(dst->floats.end(), s->floats.begin() + from,
+                         s->floats.begin() + from + n);
+      return;
+    case object::P_CHAR:
+      dst->chars.append(s->chars, from, n);
+      return;
+    default:
+      break;
+    }
+  dst->unpack();
+  for (int i = 0; i < n; i++) {
+    object::Object *o = src->at(i);
+    if (deep)
+      o = this->copy(o);
+    dst->elements.push_back(o);
+    object::hold(o);
+  }
+}
+
+// object of an arena copied into current heap, the others are shared
+object::Object *vm::copy(object::Object *o) {
+  if (!o->arena)
+    return o;
+
+  switch (o->kind()) {
+  case object::INT:
+    return new object::Int(static_cast<object::Int *>(o)->value);
+  case object::FLOAT: {
+    object::Float *f = new object::Float(0);
+    f->value = static_cast<object::Float *>(o)->value; // DOUBLE
+    return f;
+  }
+  case object::STR:
+    return new object::Str(static_cast<object::Str *>(o)->value);
+  case object::CHAR:
+    return new object::Char(static_cast<object::Char *>(o)->value);
+  case object::BOOL:
+    return new object::Bool(static_cast<object::Bool *>(o)->value);
+  case object::ARRAY: {
+    object::Array *a = new object::Array;
+    this->append(a, static_cast<object::Array *>(o), true);
+    return a;
+  }
+  case object::TUPLE: {
+    object::Tuple *t = new object::Tuple;
+    for (auto i : static_cast<object::Tuple *>(o)->elements) {
+      t->elements.push_back(this->copy(i));
+      object::hold(t->elements.back());
+    }
+    return t;
+  }
+  case object::MAP: {
+    object::Map *m = new object::Map;
+    for (auto &i : static_cast<object::Map *>(o)->elements) {
+      object::Object *k = this->copy(i.first);
+      object::Object *v = this->copy(i.second);
+      m->elements.insert(std::make_pair(k, v));
+      object::hold(k);
+      object::hold(v);
+    }
+    return m;
+  }
+  default:
+    error("unsupport type to result of parallel loop");
+  }
+  return nullptr;
+}
+
+// value into accumulator of reduction, strings and arrays are appended in
+// place as the accumulator is made by the loop
+object::Object *vm::fold(char op, object::Object *acc, object::Object *v) {
+  if (op != '+') {
+    if (v->kind() != object::INT && v->kind() != object::FLOAT)
+      error("unsupport type to " + std::string(1, op) + " reduction");
+    object::Object *b = this->arith(op == '<' ? byte::LE : byte::GR, v, acc);
+    return static_cast<object::Bool *>(b)->value ? v : acc; // LEAST OR MOST
+  }
+  switch (acc->kind()) {
+  case object::STR:
+    if (v->kind() != object::STR)
+      error("unsupport type to + reduction");
+    static_cast<object::Str *>(acc)->value +=
+        static_cast<object::Str *>(v)->value;
+    return acc;
+  case object::ARRAY:
+    if (v->kind() != object::ARRAY)
+      error("unsupport type to + reduction");
+    this->append(static_cast<object::Array *>(acc),
+                 static_cast<object::Array *>(v), false);
+    return acc;
+  default:
+    return this->arith(byte::ADD, acc, v);
+  }
+}
+
+// table of a frame of worker or of its whole
+bool vm::mine(Table *t) {
+  for (auto i : this->frames)
+    if (&i->tb == t ||
+        (i->up != nullptr && object::owned(i->up) &&
+         &static_cast<object::Whole *>(i->up)->f->tb == t))
+      return true;
+  return false;
+}
+
+// run iterations from first to end of parallel loop on a new worker, in an
+// arena of its own which is freed after
+std::vector<object::Object *>
+vm::chunk(Entity *e, Table *tb, object::Object *obj, int lo, int hi,
+          const std::string &index, const std::string &element,
+          std::vector<object::Object *> &outer, gc::Heap *kept,
+          State *state) {
+  std::unique_ptr<gc::Heap> arena(new gc::Heap);
+  arena->arena = true;
+  gc::Scope scope(arena.get());
+
+  vm w(e, this->mods, false, false, state);
+  w.worker = true;
+
+  Frame *f = w.main();
+  f->tb.parent = tb; // NAMES OF LOOP
+
+  std::vector<object::Object *> acc;
+  for (int k = 0; k < outer.size(); k++)
+    acc.push_back(e->reduce.at(k).first == '+' ? identity(outer.at(k))
+                                               : outer.at(k));
+
+  for (int i = lo; i < hi; i++) {
+    object::Object *x = new object::Int(i);
+    if (index != element)
+      f->tb.emit(index, x);
+    f->tb.emit(element, obj->kind() == object::ARRAY
+                            ? static_cast<object::Array *>(obj)->at(i)
+                            : x);
+    // OWN VALUES OF REDUCTIONS
+    for (int k = 0; k < outer.size(); k++)
+      f->tb.emit(e->reduce.at(k).second, e->reduce.at(k).first == '+'
+                                             ? identity(outer.at(k))
+                                             : outer.at(k));
+    w.evaluate();
+    f->data.clear(); // VALUES OF EXPRESSION STATEMENTS
+
+    for (int k = 0; k < outer.size(); k++)
+      acc.at(k) = w.fold(e->reduce.at(k).first, acc.at(k),
+                         f->tb.lookUp(e->reduce.at(k).second));
+    f->clean(); // LOCALS OF ITERATION
+  }
+
+  gc::Scope into(kept);
+  for (auto &i : acc)
+    i = w.copy(i);
+  return acc;
+}
+
+// run body of parallel loop over count or array in chunks on threads, then
+// fold reductions into their names in order of iterations
+void vm::par(object::Func *f, object::Object *obj, const std::string &index,
+             const std::string &element) {
+  int n = 0;
+  if (obj->kind() == object::INT)
+    n = std::max(0, static_cast<object::Int *>(obj)->value);
+  else if (obj->kind() == object::ARRAY)
+    n = static_cast<object::Array *>(obj)->size();
+  else
+    error("parallel loop of <int> count or array only");
+
+  Entity *e = f->entity;
+  std::vector<object::Object *> outer; // VALUES BEFORE LOOP
+  for (auto &r : e->reduce) {
+    object::Object *o = this->lookUp(r.second);
+    if (o == nullptr)
+      error("not defined name '" + r.second + "'");
+
+    object::Kind k = o->kind();
+    if (k != object::INT && k != object::FLOAT &&
+        (r.first != '+' || (k != object::STR && k != object::ARRAY)))
+      error("unsupport type to " + std::string(1, r.first) +
+            " reduction of '" + r.second + "'");
+    outer.push_back(o);
+  }
+
+  // NESTED ONES RUN ON THE WORKER
+  int threads =
+      this->worker ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  int grain = std::min(grainMost, std::max(1, n / (threads * grainEach)));
+  int chunks = (n + grain - 1) / grain;
+  threads = std::max(1, std::min({threads, chunks, workers()->size + 1}));
+
+  std::vector<std::vector<object::Object *>> parts(chunks);
+  std::vector<std::unique_ptr<gc::Heap>> kept(threads); // PARTS OF THREAD
+
+  std::atomic<int> taken{0};
+  std::atomic<bool> stop{false};
+  std::exception_ptr failure; // OF THE FIRST CHUNK
+  int failed = chunks;
+  std::mutex m;
+
+  Table *tb = &top()->tb;
+  auto run = [&](int t) {
+    kept.at(t).reset(new gc::Heap);
+    kept.at(t)->arena = true;
+    State state = *this->state;
+
+    for (int c; !stop && (c = taken++) < chunks;)
+      try {
+        parts.at(c) = this->chunk(e, tb, obj, c * grain,
+                                  std::min(n, (c + 1) * grain), index,
+                                  element, outer, kept.at(t).get(), &state);
+      } catch (...) {
+        std::lock_guard<std::mutex> l(m);
+        if (c < failed) {
+          failure = std::current_exception();
+          failed = c;
         }
+        stop = true;
       }
-      // <Float> > <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, >,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, >,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
-      } else
-        // ERROR
-        error("unsupport type to > operator");
-    } break;
+  };
+
+  int busy = threads - 1; // ON THREADS OF POOL
+  std::condition_variable done;
+  for (int t = 1; t < threads; t++)
+    workers()->submit([&, t] {
+      run(t);
+      std::lock_guard<std::mutex> l(m);
+      if (--busy == 0)
+        done.notify_one();
+    });
+  run(0); // ON THIS THREAD TOO
+  {
+    std::unique_lock<std::mutex> l(m);
+    done.wait(l, [&] { return busy == 0; });
+  }
+
+  if (failure != nullptr)
+    std::rethrow_exception(failure);
+
+  // IN ORDER OF CHUNKS, FROM VALUES BEFORE LOOP
+  for (int k = 0; k < outer.size(); k++) {
+    char op = e->reduce.at(k).first;
+    object::Object *acc = outer.at(k);
+    if (op == '+')
+      acc = this->fold(op, identity(acc), acc);
+
+    for (auto &p : parts)
+      acc = this->fold(op, acc, this->copy(p.at(k)));
+    this->emitTable(e->reduce.at(k).second, acc);
+  }
+}
+
+// lowest address of C stack of current thread
+static char *threadStack() {
+  static thread_local char *low = nullptr;
+  if (low != nullptr)
+    return low;
+
+  pthread_attr_t a;
+  void *addr = nullptr;
+  size_t size = 0;
+  if (pthread_getattr_np(pthread_self(), &a) == 0) {
+    pthread_attr_getstack(&a, &addr, &size);
+    pthread_attr_destroy(&a);
+  }
+  return low = static_cast<char *>(addr);
+}
+
+void vm::evaluate() { // EVALUATE
+  char here; // ON C STACK OF RUNNING TASK OR THREAD
+  char *low = this->own != nullptr ? this->own->cstack : threadStack();
+  if (low != nullptr && &here - low < (std::ptrdiff_t)stackMargin)
+    error("stack overflow");
+
+#define BINARY_OP(T, L, OP, R) PUSH(new T(L OP R));
+
+  Entity *en = top()->entity; // entity of current frame
+  byte::Code co = byte::RET;  // previous is none
+
+  int start = top()->ip; // RESUME OF GENERATOR
+  top()->ip = 0;
+
+  for (int ip = start; ip < en->codes.size();) { // MAIN LOOP
+    byte::Code prev = co;                   // previous bytecode
+
+    if (this->heap->pending) { // SAFE POINT
+      gc::step([this] { this->roots(); });
+      if (this->own != nullptr && this->own->group->stop)
+        error("task is ended");
+    }
+
+    this->lp = ip;
+
+    // bytecode
+    co = (byte::Code)en->codes[ip++];
+
+    switch (co) {
+    case byte::CONST: { // CONST
+      object::Object *obj = this->retConstant(&ip);
+
+
+      // STRING TEMPLATE
+      if (obj->kind() == object::STR) {
+        object::Str *s = static_cast<object::Str *>(obj);
 
-    case byte::GR_E: { // >=
-      object::Object *y = POP();
-      object::Object *x = POP();
+        char *data = s->value.data(); // CHARS
+        int count = 0;                // COUNT
 
-      // <Int> >= <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, >=,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, >=,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
-      }
-      // <Float> >= <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, >=,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, >=,
-                    static_cast<object::Float *>(y)->value);
+        while (*data++ != '\0')
+          if (*data == '$')
+            count++; // GET COUNT OF $
+
+        if (count == 0) { // NONE
+          PUSH(obj);
           break;
         }
-      } else
-        // ERROR
-        error("unsupport type to >= operator");
-    } break;
 
-    case byte::LE: { // <
-      object::Object *y = POP();
-      object::Object *x = POP();
+        object::Str *n = new object::Str(s->value); // NEW
 
-      // <Int> < <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, <,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, <,
-                    static_cast<object::Float *>(y)->value);
-          break;
+        while (count-- > 0) {
+
+          for (int i = 0; i < n->value.size(); i++) {
+            if (n->value.at(i) == '$') {
+              i++; // SKIP LEFT $
+
+              // TO NAME
+              std::string r;
+
+              // GET NAME
+              while (i < n->value.size() && isalpha(n->value.at(i))) {
+                r.push_back(n->value.at(i));
+                i++;
+              }
+
+              if (r.empty())
+                error("string template need a ident name");
+              object::Object *o = this->lookUp(r); // OBJECT
+
+              if (o == nullptr)
+                error("not defined name '" + r + "'");
+
+              int p = i - r.size() - 1; // START
+
+              n->value.erase(p, r.size() + 1);   // REMOVE
+              n->value.insert(p, o->stringer()); // INSERT
+
+              break; // NEXT
+            }
+          }
         }
+
+        PUSH(n);
+        break;
       }
-      // <Float> < <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, <,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, <,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
-      } else
-        // ERROR
-        error("unsupport type to < operator");
+
+      PUSH(obj);
     } break;
 
+      //
+      // BINARY OPERATOR START
+      //
+
+    case byte::ADD:    // +
+    case byte::SUB:    // -
+    case byte::MUL:    // *
+    case byte::DIV:    // /
+    case byte::SUR:    // %
+    case byte::GR:     // >
+    case byte::GR_E:   // >=
+    case byte::LE:     // <
     case byte::LE_E: { // <=
       object::Object *y = POP();
       object::Object *x = POP();
 
-      // <Int> <= <Int> <Float>
-      if (x->kind() == object::INT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, <=,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Int *>(x)->value, <=,
-                    static_cast<object::Float *>(y)->value);
+      // <Str> + <Str> NOT ESCAPING
+      if (this->local && x->kind() == object::STR &&
+          y->kind() == object::STR) {
+        object::Str *l = static_cast<object::Str *>(x);
+        object::Str *r = static_cast<object::Str *>(y);
+
+        if (!l->longer && !r->longer) {
+          PUSH(this->make<object::Str>(l->value + r->value));
           break;
         }
       }
-      // <Float> <= <Int> <Float>
-      else if (x->kind() == object::FLOAT) {
-        switch (y->kind()) {
-        case object::INT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, <=,
-                    static_cast<object::Int *>(y)->value);
-          break;
-        //
-        case object::FLOAT:
-          BINARY_OP(object::Bool, static_cast<object::Float *>(x)->value, <=,
-                    static_cast<object::Float *>(y)->value);
-          break;
-        }
-      } else
-        // ERROR
-        error("unsupport type to <= operator");
+      this->local = false;
+
+      object::Object *r = this->arith(co, x, y); // RESULT
+      if (r != nullptr)
+        PUSH(r);
     } break;
 
     case byte::E_E: { // ==
@@ -1282,14 +2611,13 @@ void vm::evaluate() { // EVALUATE
 
     case byte::STORE: { // STORE
       object::Object *obj;
-      std::string name = this->retName(); // TO NAME
+      std::string name = this->retName(&ip); // TO NAME
 
       // std::cout << "STORE: " << name << std::endl;
 
-      this->op++;
-      Type *type = this->retType(); // TO TYPE
+      Type *type = this->retType(&ip); // TO TYPE
 
-      if (top()->entity->codes.at(ip - 1) == byte::ORIG) { // ORIGINAL
+      if (prev == byte::ORIG) {               // ORIGINAL
         obj = this->setOriginalValue(type);                // VALUE
       } else {
         obj = POP(); // OBJECT
@@ -1301,28 +2629,33 @@ void vm::evaluate() { // EVALUATE
       if (type->kind() == T_ARRAY) {
         Array *T = static_cast<Array *>(type);
         object::Array *a = static_cast<object::Array *>(obj);
+        if (!object::owned(a))
+          obj = a = a->clone(); // OF ANOTHER HEAP, READ ONLY
 
-        for (int i = a->elements.size(); i < T->count; i += 1) {
+        gc::write(a);  // ELEMENTS OF ORIGINAL VALUE
+        a->pack(T->T); // PRIMITIVE STORAGE
+        a->grow(T->count);
+
+        for (int i = a->size(); i < T->count; i += 1) {
           a->elements.insert(a->elements.begin() + i,
                              this->setOriginalValue(T->T)); // TO ORIGINAL VALUE
+          object::hold(a->elements.at(i));
         }
       }
 
       this->emitTable(name, obj); // STORE
-      this->op++;
     } break;
 
     case byte::LOAD: {
-      std::string name = this->retName(); // NAME
+      std::string name = this->retName(&ip); // NAME
       // std::cout << "LOAD: " << name << std::endl;
 
       // LOAD BUILTIN
-      if (isBuiltinName(name)) {
+      if (isBuiltinName(name) || isTaskName(name)) {
         object::Func *f = new object::Func;
         f->name = name;
 
         PUSH(f);
-        this->op++;
         break;
       }
 
@@ -1354,51 +2687,53 @@ void vm::evaluate() { // EVALUATE
       }
 
       PUSH(obj);
-      this->op++;
     } break;
 
     case byte::B_ARR: {
-      int count = this->retOffset(); // COUNT
+      int count = this->retOffset(&ip); // COUNT
 
-      object::Array *arr = new object::Array;
+      object::Array *arr = this->make<object::Array>();
       // emit elements
-      for (int i = 0; i < count; i++)
+      for (int i = 0; i < count; i++) {
         arr->elements.push_back(POP());
+        object::hold(arr->elements.back());
+      }
 
       PUSH(arr);
-      this->op++;
     } break;
 
     case byte::B_TUP: {
-      int count = this->retOffset(); // COUNT
+      int count = this->retOffset(&ip); // COUNT
 
-      object::Tuple *tup = new object::Tuple;
+      object::Tuple *tup = this->make<object::Tuple>();
       // emit elements
-      for (int i = 0; i < count; i++)
+      for (int i = 0; i < count; i++) {
         tup->elements.push_back(POP());
+        object::hold(tup->elements.back());
+      }
 
       PUSH(tup);
-      this->op++;
     } break;
 
     case byte::B_MAP: {
-      int count = this->retOffset(); // COUNT
+      int count = this->retOffset(&ip); // COUNT
 
-      object::Map *map = new object::Map;
+      object::Map *map = this->make<object::Map>();
       // emit elements
       for (int i = 0; i < count / 2; i++) {
         object::Object *y = POP();
         object::Object *x = POP();
 
         map->elements.insert(std::make_pair(x, y));
+        object::hold(x);
+        object::hold(y);
       }
 
       PUSH(map);
-      this->op++;
     } break;
 
     case byte::ASSIGN: {
-      std::string name = this->retName(); // NAME
+      std::string name = this->retName(&ip); // NAME
       object::Object *obj = POP();        // OBJ
 
       // std::cout << "ASS: " << name << " OBJ: " << obj->stringer()
@@ -1407,49 +2742,39 @@ void vm::evaluate() { // EVALUATE
         error("not defined name '" + name + "'");
 
       this->emitTable(name, obj); // STORE
-      this->op++;
     } break;
 
     case byte::JUMP: // JUMP
 
     case byte::F_JUMP:
     case byte::T_JUMP: {
-      int off = this->retOffset(); // TO
+      int off = this->retOffset(&ip); // TO
 
-      if (co == byte::JUMP && this->loopWasRet && off < ip) {
+      if (co == byte::JUMP && this->loopWasRet && off < this->lp) {
         this->loopWasRet = false;
-        this->op++;
         break;
       }
 
       // JUMP
       if (co == byte::JUMP) {
-        this->addCounter(&ip, off);
+        ip = off;
         //
       } else {
         // T
         if (static_cast<object::Bool *>(POP())->value) {
-          if (co == byte::T_JUMP) {
-            //
-            this->addCounter(&ip, off); // T_JUMP
-          } else {
-            this->op++; // NO
-          }
+          if (co == byte::T_JUMP)
+            ip = off; // T_JUMP
         } else {
           // F
-          if (co == byte::F_JUMP) {
-            //
-            this->addCounter(&ip, off); // F_JUMP
-          } else {
-            this->op++; // NO
-          }
+          if (co == byte::F_JUMP)
+            ip = off; // F_JUMP
         }
       }
     } break;
 
     case byte::FUNC: { // FUNCTION
       object::Func *f =
-          static_cast<object::Func *>(this->retConstant()); // OBJECT
+          static_cast<object::Func *>(this->retConstant(&ip)); // OBJECT
 
       // ANONYMOUSE FUNCTION
       if (f->name == "anonymouse") {
@@ -1458,71 +2783,180 @@ void vm::evaluate() { // EVALUATE
       }
 
       this->emitTable(f->name, f); // STORE
-      this->op++;
     } break;
 
+    case byte::R_ASSIGN: // NAME = X <OP> Y
+    case byte::R_PUSH: { // X <OP> Y
+      byte::Code op = (byte::Code)this->retOffset(&ip);
+      int name = co == byte::R_ASSIGN ? this->retOffset(&ip) : -1; // NAME
+
+      object::Object *x = this->retOperand(&ip);
+      object::Object *y = this->retOperand(&ip);
+
+      object::Object *r = this->arith(op, x, y); // RESULT
+      if (r == nullptr)
+        error("unsupport type to " + byte::codeString[op] + " operator");
+
+      if (co == byte::R_PUSH) {
+        PUSH(r);
+        break;
+      }
+      const std::string &n = en->names.at(name);
+
+      if (this->lookUp(n) == nullptr)
+        error("not defined name '" + n + "'");
+
+      this->emitTable(n, r); // STORE
+    } break;
+
+    case byte::R_F_JUMP: // F_JUMP X <OP> Y
+    case byte::R_T_JUMP: {
+      byte::Code op = (byte::Code)this->retOffset(&ip);
+
+      object::Object *x = this->retOperand(&ip);
+      object::Object *y = this->retOperand(&ip);
+
+      int off = this->retOffset(&ip); // TO
+      bool v;
+
+      if (x->kind() == object::INT && y->kind() == object::INT) {
+        int l = static_cast<object::Int *>(x)->value;
+        int r = static_cast<object::Int *>(y)->value;
+
+        v = op == byte::GR ? l > r : op == byte::GR_E ? l >= r
+                                   : op == byte::LE   ? l < r
+                                                      : l <= r;
+      } else {
+        object::Object *r = this->arith(op, x, y); // RESULT
+        if (r == nullptr)
+          error("unsupport type to " + byte::codeString[op] + " operator");
+        v = static_cast<object::Bool *>(r)->value;
+      }
+
+      if (v == (co == byte::R_T_JUMP))
+        ip = off; // JUMP
+    } break;
+
+    case byte::R_MOVE: { // NAME = X
+      const std::string &name = en->names.at(this->retOffset(&ip));
+      object::Object *x = this->retOperand(&ip);
+
+      if (this->lookUp(name) == nullptr)
+        error("not defined name '" + name + "'");
+
+      this->emitTable(name, x); // STORE
+    } break;
+
+    case byte::TAIL_CALL: // CALL AND RETURN
+
     case byte::CALL: { // CALL FUNCTION
-      int args = this->retOffset();
+      int args = this->retOffset(&ip);
 
-      Stack<object::Object *> arguments;
-      while (args-- > 0 && top()->data.len() != 1) { // TOP IS FUNC OBJ
-        arguments.push(POP());                       // ARGUMENT
+      int count = 0; // ARGUMENTS ON STACK
+      while (count < args &&
+             top()->data.len() - count != 1) { // TOP IS FUNC OBJ
+        count++;
       }
+      int first = this->stack.len() - count; // FIRST ARGUMENT
 
-      object::Func *f = static_cast<object::Func *>(POP()); // FUNCTION
+      object::Func *f =
+          static_cast<object::Func *>(this->stack.at(first - 1)); // FUNCTION
       // std::cout << "CALL OF: " << f->name << std::endl;
 
       if (isBuiltinName(f->name)) {
-        while (arguments.len()) {
-          f->builtin.push_back(arguments.pop()); // BUILTIN ARGUMENTS
+        Args args; // BUILTIN ARGUMENTS
+        for (int i = first; i < this->stack.len(); i++) {
+          args.push_back(this->stack.at(i));
         }
-        builtinFuncCall(f->name, f, top()); // TO BUILTIN CALL
+        this->stack.truncate(first - 1);
 
-        this->op++;
+        builtinFuncCall(f->name, args, top()); // TO BUILTIN CALL
+        break;
+      }
+
+      if (isTaskName(f->name)) {
+        Args args; // HELD ON STACK WHILE BLOCKED
+        for (int i = first; i < this->stack.len(); i++)
+          args.push_back(this->stack.at(i));
+
+        object::Object *obj = this->taskCall(f->name, args);
+        this->stack.truncate(first - 1);
+
+        if (obj != nullptr)
+          PUSH(obj);
         break;
       }
 
       if (disMode)
         f->entity->dissemble();
 
-      Frame *fra = new Frame(f->entity); // FRAME
-
-      if (f->arguments.size() != arguments.len())
+      if (f->arguments.size() != count)
         error("wrong number of parameters");
 
+      // REUSE CURRENT FRAME
+      bool tail = co == byte::TAIL_CALL && f->ret != nullptr &&
+                  !this->callWholeMethod && this->frames.size() > 1 &&
+                  !f->gen && !top()->gen;
+
+      Frame *fra = tail ? top() : this->newFrame(f->entity); // FRAME
+
       // SET TABLE SYMBOL
-      if (this->callWholeMethod)
+      if (tail)
+        ; // KEEP CURRENT TABLE
+      else if (this->callWholeMethod) {
         // std::cout << "CALL " << (this->callWhole->name) << std::endl;
 
         // CALL WHOLE
-        fra->tb = this->callWhole->f->tb;
-      else
+        fra->tb.parent = &this->callWhole->f->tb;
+        fra->up = this->callWhole;
+      } else
         // GLOBAL
-        fra->tb.symbols = top()->tb.symbols;
-
-      // std::cout << "CALL: " << f->name << " " <<
-      // fra->tb.symbols.size()
-      //           << std::endl;
-      // std::cout << "CALL ARGS: " << arguments.len() << std::endl;
+        fra->tb.parent = &top()->tb;
 
       // ARGUMENT
+      int i = first;
       for (std::map<token::Token *, Type *>::reverse_iterator iter =
                f->arguments.rbegin();
            //  REVERSE EMIT
            iter != f->arguments.rend(); iter++) {
-        object::Object *val = arguments.pop(); // OBJECT
+        object::Object *val = this->stack.at(i++); // OBJECT
 
         this->typeChecker(iter->second, val);    // TYPE CHECKER
         fra->tb.emit(iter->first->literal, val); // STORE
       }
+      this->stack.truncate(first - 1);
+
+      // GENERATOR, SUSPENDED UNTIL ITERATED
+      if (f->gen) {
+        if (!this->callWholeMethod)
+          fra->tb.parent = &main()->tb; // OUTLIVES CALLER
+        fra->gen = true;
+
+        gc::barrier(f); // NOT STORED BY NAME
+        PUSH(new object::Gen(f, fra));
+
+        this->callWholeMethod = false;
+        this->callWhole = nullptr;
+        break;
+      }
 
-      int t = this->op; // TEMP OFFSET
+      if (tail) {
+        fra->data.clear();
 
-      this->op = 0;
-      this->frames.push_back(fra); // NEW FRAME
+        en = fra->entity = f->entity; // JUMP TO FUNCTION
+        ip = 0;
+        continue;
+      }
+
+      this->pushFrame(fra); // NEW FRAME
       this->evaluate();
 
-      this->frames.pop_back(); // POP
+      this->popFrame(); // POP
+
+      if (fra->mod.empty()) {
+        fra->drop();               // RELEASE NAMES
+        this->pool.push_back(fra); // REUSE
+      }
 
       if (f->ret != nullptr) {
         // RETURN
@@ -1546,14 +2980,23 @@ void vm::evaluate() { // EVALUATE
         this->callWholeMethod = false;
         this->callWhole = nullptr;
       }
-
-      this->op = ++t; // NEXT
     } break;
 
+    case byte::INDEX_U: // INDEX IN RANGE
+    case byte::INDEX_L: // INDEX OF NAME TO BE WRITTEN
+    case byte::INDEX_W: // INDEX TO BE WRITTEN
     case byte::INDEX: { // INDEX
-      object::Object *obj = POP();
+      object::Object *obj = co == byte::INDEX_L
+                                ? this->writable(this->retName(&ip))
+                                : POP();
       object::Object *idx = POP();
 
+      if (co == byte::INDEX_U && obj->kind() == object::ARRAY) {
+        PUSH(static_cast<object::Array *>(obj)->at(
+            static_cast<object::Int *>(idx)->value));
+        break;
+      }
+
       // GET
       switch (obj->kind()) {
       case object::ARRAY: {
@@ -1564,13 +3007,13 @@ void vm::evaluate() { // EVALUATE
         auto x = static_cast<object::Int *>(idx);   // INDEX
         auto y = static_cast<object::Array *>(obj); // TO
 
-        if (y->elements.empty())
+        if (y->size() == 0)
           error("empty element of array");
-        if (x->value >= y->elements.size()) {
+        if (x->value < 0 || x->value >= y->size()) {
           error("array out of bounds, index: " + std::to_string(x->value) +
-                " max: " + std::to_string(y->elements.size() - 1));
+                " max: " + std::to_string(y->size() - 1));
         }
-        PUSH(y->elements.at(x->value)); // PUSH
+        PUSH(y->at(x->value)); // PUSH
       } break;
       //
       case object::MAP: {
@@ -1613,40 +3056,203 @@ void vm::evaluate() { // EVALUATE
         PUSH(new object::Char(s->value.at(i->value)));
       } break;
       }
+
+      // COPY ON WRITE OF ELEMENT, PUT BACK INTO ITS ARRAY OR MAP
+      if (co != byte::INDEX_L && co != byte::INDEX_W ||
+          obj->kind() != object::ARRAY && obj->kind() != object::MAP)
+        break; // TUPLE IS NEVER WRITTEN
+      object::Object *e = POP();
+
+      if (e->kind() != object::ARRAY && e->kind() != object::MAP ||
+          !object::shared(e)) {
+        PUSH(e);
+        break;
+      }
+      if (!object::owned(obj))
+        error("parallel loop writes shared object");
+      gc::write(obj); // OLD ONE REFERS YOUNG ONES
+
+      object::Object *c =
+          e->kind() == object::ARRAY
+              ? (object::Object *)static_cast<object::Array *>(e)->clone()
+              : static_cast<object::Map *>(e)->clone();
+      object::hold(c);
+      object::release(e);
+
+      if (obj->kind() == object::ARRAY) {
+        object::Array *a = static_cast<object::Array *>(obj);
+        a->flat(); // OWN STORAGE
+        a->set(static_cast<object::Int *>(idx)->value, c);
+      } else {
+        for (auto &i : static_cast<object::Map *>(obj)->elements)
+          if (this->objValueEquation(i.first, idx)) {
+            i.second = c;
+            break;
+          }
+      }
+      PUSH(c);
     } break;
 
-    case byte::REPLACE: { // REPLACE
+    case byte::ITER_INIT: { // ITERATOR OF LOOP
+      int slot = this->retOffset(&ip); // LOOP DEPTH
+      object::Object *obj = POP();
+
+      if (obj->kind() != object::ARRAY && obj->kind() != object::MAP &&
+          obj->kind() != object::STR && obj->kind() != object::TUPLE &&
+          obj->kind() != object::GEN)
+        error("for-in of array, map, string, tuple or generator only");
+
+      std::vector<Iter> &iters = top()->iters;
+      if (slot >= iters.size())
+        iters.resize(slot + 1);
+      Iter &it = iters.at(slot);
+
+      object::hold(obj); // COPIED ON WRITE OF NAME
+      object::release(it.obj);
+
+      it.obj = obj;
+      it.pos = 0;
+      if (obj->kind() == object::MAP)
+        it.at = static_cast<object::Map *>(obj)->elements.begin();
+    } break;
+
+    case byte::ITER_NEXT: { // NEXT ELEMENT OF ITERATOR
+      Iter &it = top()->iters.at(this->retOffset(&ip));
+
+      std::string k = this->retName(&ip); // INDEX OR KEY
+      std::string v = this->retName(&ip); // ELEMENT
+      int off = this->retOffset(&ip);     // TO
+
+      object::Object *key = nullptr;
+      object::Object *val = nullptr;
+
+      switch (it.obj->kind()) {
+      case object::ARRAY: {
+        object::Array *a = static_cast<object::Array *>(it.obj);
+        if (it.pos < a->size())
+          val = a->at(it.pos);
+      } break;
+      case object::TUPLE: {
+        object::Tuple *t = static_cast<object::Tuple *>(it.obj);
+        if (it.pos < t->elements.size())
+          val = t->elements.at(it.pos);
+      } break;
+      case object::STR: {
+        object::Str *s = static_cast<object::Str *>(it.obj);
+        if (it.pos < s->value.size())
+          val = new object::Char(s->value.at(it.pos));
+      } break;
+      case object::MAP:
+        if (it.at != static_cast<object::Map *>(it.obj)->elements.end()) {
+          key = it.at->first;
+          val = it.at->second;
+          it.at++;
+        }
+        break;
+      case object::GEN:
+        val = this->resume(static_cast<object::Gen *>(it.obj));
+        break;
+      }
+
+      if (val == nullptr) { // END
+        object::release(it.obj);
+        it.obj = nullptr;
+        ip = off;
+        break;
+      }
+      if (key == nullptr && k != v)
+        key = new object::Int(it.pos);
+      it.pos++;
+
+      if (k == v) {
+        // one name, key of map or element
+        this->emitTable(v, key != nullptr ? key : val);
+        break;
+      }
+      this->emitTable(k, key);
+      this->emitTable(v, val);
+    } break;
+
+    case byte::SLICE: { // SLICE
+      int given = this->retOffset(&ip); // BOUNDS
+
       object::Object *obj = POP();
+      object::Object *lo = given & 1 ? POP() : nullptr;
+      object::Object *hi = given & 2 ? POP() : nullptr;
+
+      if (lo != nullptr && lo->kind() != object::INT ||
+          hi != nullptr && hi->kind() != object::INT)
+        error("slice bounds can only be integers");
+
+      int size;
+      if (obj->kind() == object::ARRAY)
+        size = static_cast<object::Array *>(obj)->size();
+      else if (obj->kind() == object::STR)
+        size = static_cast<object::Str *>(obj)->value.size();
+      else
+        error("slice of array or string only");
+
+      int x = lo == nullptr ? 0 : static_cast<object::Int *>(lo)->value;
+      int y = hi == nullptr ? size : static_cast<object::Int *>(hi)->value;
+
+      if (x < 0 || x > y || y > size)
+        error("slice out of bounds, range: " + std::to_string(x) + ":" +
+              std::to_string(y) + " length: " + std::to_string(size));
+
+      if (obj->kind() == object::STR) {
+        PUSH(new object::Str(
+            static_cast<object::Str *>(obj)->value.substr(x, y - x)));
+        break;
+      }
+      object::Array *a = static_cast<object::Array *>(obj);
+
+      // small part would keep the whole storage alive, copy it
+      if (y - x < viewLeast || (y - x) * 4 < size) {
+        object::Array *r = a->slice(x, y);
+        r->flat();
+        PUSH(r);
+        break;
+      }
+      PUSH(a->slice(x, y)); // VIEW
+    } break;
+
+    case byte::REPLACE_L: // REPLACE OF NAME
+    case byte::REPLACE_U: // REPLACE OF NAME IN RANGE
+    case byte::REPLACE: { // REPLACE
+      object::Object *obj;
+      if (co == byte::REPLACE) {
+        obj = POP();
+      } else {
+        obj = this->writable(this->retName(&ip)); // NAME
+      }
       object::Object *idx = POP();
       object::Object *val = POP();
 
+      if (!object::owned(obj))
+        error("parallel loop writes shared object");
+      gc::write(obj); // OLD ONE REFERS YOUNG ONES
+
       // SET
       switch (obj->kind()) {
       case object::ARRAY: {
-        if (idx->kind() != object::INT) {
+        if (co != byte::REPLACE_U && idx->kind() != object::INT) {
           error("array subscript index can only be an integer");
         }
 
         object::Array *a = static_cast<object::Array *>(obj);
         int i = static_cast<object::Int *>(idx)->value;
 
-        if (i >= a->elements.size()) {
+        if (co != byte::REPLACE_U && (i < 0 || i >= a->size())) {
           error("array out of bounds, index: " + std::to_string(i) +
-                " max: " + std::to_string(a->elements.size() - 1));
+                " max: " + std::to_string(a->size() - 1));
         }
 
-        // REPLACE
-        std::replace(std::begin(a->elements), std::end(a->elements),
-                     a->elements.at(i), val);
-
-        // RESTORE
-        if (top()->entity->codes.at(ip) == byte::LOAD) {
-          this->emitTable(
-              // NAME
-              top()->entity->names.back(),
-              // VALUE
-              a);
-        }
+        a->flat(); // OWN STORAGE
+        if (a->packed == object::P_OBJ)
+          object::release(a->elements[i]);
+        object::hold(val);
+
+        a->set(i, val); // IN PLACE
       } break;
       //
       case object::MAP: {
@@ -1662,26 +3268,21 @@ void vm::evaluate() { // EVALUATE
         if (iter == m->elements.end()) { // NOT FOUND
           // INSERT
           m->elements.insert(std::make_pair(idx, val));
+          object::hold(idx);
         } else {
           // REPLACE
+          object::release(iter->second);
           iter->second = val;
         }
-
-        // RESTORE
-        if (top()->entity->codes.at(ip) == byte::LOAD) {
-          this->emitTable(
-              // NAME
-              top()->entity->names.back(),
-              // VALUE
-              m);
-        }
+        object::hold(val);
       } break;
         //
       }
     } break;
 
-    case byte::GET: { // GET
-      std::string name = this->retName();
+    case byte::GET_W: // GET TO BE WRITTEN
+    case byte::GET: {  // GET
+      std::string name = this->retName(&ip);
       object::Object *obj = POP();
 
       switch (obj->kind()) {
@@ -1736,6 +3337,20 @@ void vm::evaluate() { // EVALUATE
         if (op == nullptr)
           error("nonexistent member '" + name + "'");
 
+        // COPY ON WRITE OF MEMBER, PUT BACK INTO ITS WHOLE
+        if (co == byte::GET_W &&
+            (op->kind() == object::ARRAY || op->kind() == object::MAP) &&
+            object::shared(op) && w->f->tb.owner(name) == &w->f->tb) {
+          if (!object::owned(w))
+            error("parallel loop writes shared object");
+          gc::write(w); // OLD ONE REFERS YOUNG ONES
+
+          op = op->kind() == object::ARRAY
+                   ? (object::Object *)static_cast<object::Array *>(op)->clone()
+                   : static_cast<object::Map *>(op)->clone();
+          w->f->tb.emit(name, op);
+        }
+
         if (op->kind() == object::FUNC) {
           this->callWholeMethod = true;
           this->callWhole = w; // CALL WHOLE METHOD
@@ -1746,12 +3361,11 @@ void vm::evaluate() { // EVALUATE
       default:
         error("nonexistent member '" + name + "'");
       }
-      this->op++;
     } break;
 
     case byte::SET: { // SET
       object::Object *w = POP();
-      std::string name = this->retName(); // NAME
+      std::string name = this->retName(&ip); // NAME
 
       if (w->kind() != object::WHOLE)
         error("the value type is not whole object");
@@ -1763,51 +3377,48 @@ void vm::evaluate() { // EVALUATE
         error("should new one first");
       if (n->f->tb.lookUp(name) == nullptr)
         error("no member '" + name + "' to set");
+      if (!object::owned(n))
+        error("parallel loop writes shared object");
 
+      gc::write(n);
       n->f->tb.emit(name, POP()); // SET
 
-      this->op++;
     } break;
 
     case byte::ENUM: { // ENUM
       object::Enum *e =
-          static_cast<object::Enum *>(this->retConstant()); // OBJECT
+          static_cast<object::Enum *>(this->retConstant(&ip)); // OBJECT
       this->emitTable(e->name, e);                          // STORE
-      this->op++;
     } break;
 
     case byte::WHOLE: { // WHOLE
       object::Whole *w =
-          static_cast<object::Whole *>(this->retConstant()); // OBJECT
+          static_cast<object::Whole *>(this->retConstant(&ip)); // OBJECT
 
       if (this->disMode)
         w->entity->dissemble();
 
       this->emitTable(w->name, w); // STORE
-      this->op++;
     } break;
 
     case byte::NAME: { // NAME
-      PUSH(new object::Str(this->retName()));
-      this->op++;
+      PUSH(new object::Str(this->retName(&ip)));
     } break;
 
     case byte::NEW: { // NEW
-      std::string name = this->retName();
+      std::string name = this->retName(&ip);
 
-      this->op++;
-      int count = this->retOffset(); // COUNT
+      int count = this->retOffset(&ip); // COUNT
 
       this->newWhole(name, count, false);
     } break;
 
     case byte::MOD: { // MOD
-      top()->mod = this->retName();
-      this->op++;
+      top()->mod = this->retName(&ip);
     } break;
 
     case byte::USE: { // USE
-      std::string name = this->retName();
+      std::string name = this->retName(&ip);
       std::vector<object::Module *> m = getModule(this->mods, name);
 
       if (m.empty())
@@ -1815,17 +3426,44 @@ void vm::evaluate() { // EVALUATE
 
       // STORE
       this->emitModule(m);
-      this->op++;
     } break;
 
     case byte::DEL: { // DEL
-      std::string name = this->retName();
+      std::string name = this->retName(&ip);
 
       if (this->lookUp(name) == nullptr)
         error("not defined name '" + name + "'");
 
       top()->tb.remove(name);
-      this->op++;
+    } break;
+
+    case byte::YIELD: { // YIELD OF GENERATOR
+      if (!top()->gen)
+        error("yield outside of generator");
+
+      this->frames.at(this->frames.size() - 2)->ret = POP(); // VALUE
+      top()->ip = ip; // SUSPEND
+      return;
+    }
+
+    case byte::LOCAL: { // NEXT ALLOCATION NOT ESCAPING
+      this->local = true;
+    } break;
+
+    case byte::PAR: { // PARALLEL LOOP
+      object::Func *f =
+          static_cast<object::Func *>(this->retConstant(&ip)); // BODY
+      std::string index = this->retName(&ip);
+      std::string element = this->retName(&ip);
+
+      if (this->disMode)
+        f->entity->dissemble();
+      this->par(f, POP(), index, element);
+    } break;
+
+    case byte::TEMP: { // TEMPORARY OF OPTIMIZER
+      std::string name = this->retName(&ip);
+      top()->tb.emit(name, POP());
     } break;
 
     case byte::RET_N: // RET NONE
@@ -1835,7 +3473,7 @@ void vm::evaluate() { // EVALUATE
         // TO PREVIOUS FRAME
         if (co != byte::RET_N)
           this->frames.at(this->frames.size() - 2)->ret = POP(); // VALUE
-        ip = top()->entity->codes.size();                        // CATCH
+        ip = en->codes.size();                                   // CATCH
       }
 
       // loop exit and no return value return
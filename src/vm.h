@@ -17,15 +17,21 @@
 
 #include <algorithm>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <map>
+#include <new>
 
 #include "builtin.h"
 #include "entity.h"
 #include "exception.h"
 #include "frame.h"
+#include "http.h"
 #include "module.h"
 #include "object.h"
 #include "opcode.h"
 #include "state.h"
+#include "task.h"
 #include "type.h"
 #include "util.h"
 
@@ -34,6 +40,18 @@ class vm {
 private:
   std::vector<Frame *> frames; // execute frames
 
+  Stack<object::Object *> stack{256}; // values of all frames
+  std::vector<Frame *> pool;          // frames to be reused
+
+  // a frame from pool, or new one if pool is empty
+  Frame *newFrame(Entity *);
+
+  // push a frame and open its window of value stack
+  void pushFrame(Frame *);
+
+  // pop the top frame and drop its values
+  void popFrame();
+
   // push object to the current frame
   void pushData(object::Object *);
 
@@ -41,28 +59,37 @@ private:
   object::Object *popData();
 
   // emit new name of table to the current frame
-  void emitTable(std::string, object::Object *);
+  void emitTable(const std::string &, object::Object *);
 
   // emit some objects in module to the current frame
   void emitModule(std::vector<object::Module *>);
 
   // look up a name from current top frame
-  object::Object *lookUp(std::string);
+  object::Object *lookUp(const std::string &);
 
   // look up a name from main frame
-  object::Object *lookUpMainFrame(std::string);
+  object::Object *lookUpMainFrame(const std::string &);
+
+  // look up a name to be written in place, a copy is bound to it if shared
+  object::Object *writable(const std::string &);
 
   // first to end iterator
-  object::Object *retConstant();
+  object::Object *retConstant(int *);
 
   // first to end iterator
-  Type *retType();
+  Type *retType(int *);
 
   // first to end iterator
-  std::string retName();
+  std::string retName(int *);
 
   // first to end iterator
-  int retOffset();
+  int retOffset(int *);
+
+  // operand of three address bytecode, constant or value of name
+  object::Object *retOperand(int *);
+
+  // arithmetic and comparison of numbers, + of strings
+  object::Object *arith(byte::Code, object::Object *, object::Object *);
 
   // are the comparison types the same
   void typeChecker(Type *, object::Object *);
@@ -73,10 +100,7 @@ private:
   // generate default values
   object::Object *setOriginalValue(Type *);
 
-  int op = 0; // offset pointer
-  int lp = 0;
-
-  void addCounter(int *, int); // add counter for bytecode within jump
+  int lp = 0; // position of current bytecode
 
   bool callWholeMethod = false;       // is current calling whole
   object::Whole *callWhole = nullptr; // of current calling whole
@@ -84,8 +108,16 @@ private:
   // loop exit and no return value return
   bool loopWasRet = false;
 
+  // next allocation does not escape the frame
+  bool local = false;
+
+  // new object, in scratch of the frame if it is local
+  template <class T, class... A> T *make(A &&...);
+
   std::vector<object::Module *> *mods; // to global modules of program
 
+  gc::Heap *heap = gc::current; // of runtime, allocations are collected by it
+
   bool replMode = false, disMode = false; // cursor vars
 
   State *state;
@@ -94,14 +126,89 @@ private:
   inline void error(std::string);
 
   void newWhole(std::string, int, bool); // to execute the whole
+
+  // mark objects of value stack, frames, and modules or function of task
+  void roots();
+
+  // run generator to its next yield, nullptr if it returned
+  object::Object *resume(object::Gen *);
   void checkInterface(object::Whole *,
                       object::Whole *); // to check interface of whole
 
+  // call a function with arguments in order on the top, its return value
+  object::Object *invoke(object::Func *, std::vector<object::Object *> &);
+
+  Task *own = nullptr;    // task run by vm, none of the program
+  Group *group = nullptr; // tasks of program, made by the first one
+
+  Task *self(); // running task, the main one is made at first
+
+  // builtin of tasks, arguments in order of stack, its return value or
+  // nullptr, the arguments are held on stack by caller while it is blocked
+  object::Object *taskCall(const std::string &,
+                           std::vector<object::Object *> &);
+
+  // block running task until it is woken, the lock of what it awaits is
+  // released once the task is blocked, and not taken again
+  void park(std::unique_lock<std::mutex> &);
+  void wakeOne(std::deque<Task *> &); // first blocked one of queue
+
+  static void launch(); // entry of task on its C stack
+
+  // builtin of descriptors, the running task is blocked until it is ready
+  object::Object *ioCall(const std::string &,
+                         std::vector<object::Object *> &);
+
+  // block running task until descriptor is readable or writable, false if it
+  // is always ready
+  bool await(int, bool);
+
+  // write all bytes, the running task awaits descriptor while it is full,
+  // false by error
+  bool flush(int, const char *, size_t);
+
+  // new task of function, its arguments and the names of program copied
+  // into its heap, ready to run on any thread
+  Task *start(object::Func *, std::vector<object::Object *> &, int);
+  void connection(Task *); // serve requests of HTTP connection of task
+
+  // object copied into current heap with all it refers, each one once,
+  // permanent ones are shared and copies of a channel share its queue
+  object::Object *transfer(object::Object *,
+                           std::map<object::Object *, object::Object *> &);
+
+  void end(); // end tasks of program, the blocked ones are woken to end
+
+  // runs chunks of a parallel loop, objects of other heaps are read only
+  bool worker = false;
+
+  // run body of parallel loop over count or array, then fold reductions
+  void par(object::Func *, object::Object *, const std::string &,
+           const std::string &);
+
+  // run iterations of parallel loop from first to end on a new worker, its
+  // partial results of reductions are copied into the kept heap
+  std::vector<object::Object *>
+  chunk(Entity *, Table *, object::Object *, int, int, const std::string &,
+        const std::string &, std::vector<object::Object *> &, gc::Heap *,
+        State *);
+
+  // value into accumulator of reduction
+  object::Object *fold(char, object::Object *, object::Object *);
+
+  // object of an arena copied into current heap
+  object::Object *copy(object::Object *);
+
+  // elements of array appended to the other one, copied if deep
+  void append(object::Array *, object::Array *, bool);
+
+  bool mine(Table *); // table of a frame of worker or of its whole
+
 public:
   explicit vm(Entity *m, std::vector<object::Module *> *mods, bool replMode,
               bool disMode, State *state) {
     // to main frame as main
-    this->frames.push_back(new Frame(m));
+    this->pushFrame(new Frame(m));
     this->mods = mods; // set global modules
     this->replMode = replMode;
     this->disMode = disMode;
@@ -110,16 +217,21 @@ public:
     regBuiltinName(main()); // builtin names
   }
 
+  ~vm();
+
   // top frame
   Frame *top();
 
   // main frame
   Frame *main();
 
-  // repl mode to clean pointer for offset
-  inline void clean() { this->op = 0; }
-
   void evaluate(); // evaluate the top of frame
+
+  // call a function of main frame with arguments in order, its return value
+  object::Object *call(const std::string &, std::vector<object::Object *> &);
+
+  // run spawned tasks until none is ready, sleeping or awaiting descriptor
+  void join();
 };
 
 #endif
\ No newline at end of file
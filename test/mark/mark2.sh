@@ -0,0 +1,42 @@
+# MARK 2
+#
+# Compile time of large generated scripts, run from the project root:
+#
+#     ./test/mark/mark2.sh [lines]
+#
+# Each block defines a new name and carries an if / ef / nf chain and a loop
+# with out and go, the program doubles in size every step and the time
+# should double with it.
+
+lines=${1:-100000}
+file=/tmp/drift_mark2.ft
+
+for n in $((lines / 4)) $((lines / 2)) $lines
+do
+    rm -f $file
+    for ((i = 0; i < n / 16; i++))
+    do
+        v=v$(echo $i | tr 0-9 a-j) # names are letters only
+        k=k$(echo $i | tr 0-9 a-j)
+        cat >> $file <<EOF
+def $v: int = $i
+if $v > $i
+    $v = 0
+ef $v < 0
+    $v = 1
+nf
+    $v += 1
+end
+for def $k: int = 0; $k < 0; $k += 1
+    go $k == 1
+    out $k == 2
+end
+aop ->
+    out $v >= 0
+end
+EOF
+    done
+    echo "$(wc -l < $file) lines"
+    time ./drift $file
+done
+rm -f $file
\ No newline at end of file
@@ -0,0 +1,28 @@
+# MARK 3
+#
+# Indexed stores into arrays, run from the project root:
+#
+#     ./test/mark/mark3.sh [count]
+#
+# Each step doubles the length of the arrays and fills them one element at
+# a time, a store is a direct write to its slot so the time should double
+# with it.
+
+count=${1:-200000}
+file=/tmp/drift_mark3.ft
+
+for n in $((count / 4)) $((count / 2)) $count
+do
+    cat > $file <<EOF
+def a: [$n]int
+def b: [$n]str
+for def i: int = 0; i < len(a); i += 1
+    a[i] = i
+    b[i] = "s"
+end
+putl(a[$n - 1], b[0])
+EOF
+    echo "$n elements"
+    time ./drift $file
+done
+rm -f $file
@@ -0,0 +1,77 @@
+# MARK 4
+#
+# Load generator of HTTP/1.1 server, keeps each connection busy with a
+# number of pipelined requests and reports requests per second and latency:
+#
+#     python3 mark4.py <port> [connections] [seconds] [pipeline]
+
+import selectors
+import socket
+import sys
+import time
+
+port = int(sys.argv[1])
+conns = int(sys.argv[2]) if len(sys.argv) > 2 else 64
+seconds = float(sys.argv[3]) if len(sys.argv) > 3 else 5
+depth = int(sys.argv[4]) if len(sys.argv) > 4 else 1
+
+request = b'GET /mark HTTP/1.1\r\nHost: localhost\r\n\r\n'
+sel = selectors.DefaultSelector()
+latency = []
+
+
+class Conn:
+    def __init__(self):
+        self.sock = socket.create_connection(('127.0.0.1', port))
+        self.sock.setblocking(False)
+        self.buf = b''
+        self.sent = []  # times of requests in flight
+        sel.register(self.sock, selectors.EVENT_READ, self)
+        self.send(depth)
+
+    def send(self, n):
+        self.sock.sendall(request * n)
+        now = time.perf_counter()
+        self.sent.extend([now] * n)
+
+    def read(self, going):
+        data = self.sock.recv(65536)
+        if not data:
+            raise SystemExit('server closed connection')
+        self.buf += data
+        done = 0
+        while True:
+            end = self.buf.find(b'\r\n\r\n')
+            if end < 0:
+                break
+            head = self.buf[:end].lower()
+            at = head.find(b'content-length:')
+            length = int(head[at + 15:].split(b'\r\n')[0]) if at >= 0 else 0
+            if len(self.buf) < end + 4 + length:
+                break
+            self.buf = self.buf[end + 4 + length:]
+            latency.append(time.perf_counter() - self.sent.pop(0))
+            done += 1
+        if going and done:
+            self.send(done)
+
+
+pool = [Conn() for _ in range(conns)]
+start = time.perf_counter()
+end = start + seconds
+while True:
+    now = time.perf_counter()
+    going = now < end
+    if not going and all(not c.sent for c in pool):
+        break
+    for key, _ in sel.select(timeout=1):
+        key.data.read(going)
+took = time.perf_counter() - start
+
+latency.sort()
+n = len(latency)
+print('%d connections, pipeline %d, %.1fs' % (conns, depth, took))
+print('%12s %10s %10s %10s' % ('REQUESTS/S', 'P50', 'P99', 'MAX'))
+print('%12.0f %8.2fms %8.2fms %8.2fms' % (
+    n / took, latency[n // 2] * 1e3, latency[n * 99 // 100] * 1e3,
+    latency[-1] * 1e3))
@@ -0,0 +1,35 @@
+# MARK 4
+#
+# HTTP server of drift under load on localhost, run from the project root:
+#
+#     ./test/mark/mark4.sh [connections] [seconds] [pipeline]
+#
+# Each request is answered by a drift handler, the load generator reports
+# requests per second and percentiles of latency, first of one request at
+# a time on each connection, then of pipelined ones.
+
+conns=${1:-64}
+seconds=${2:-5}
+depth=${3:-16}
+port=18080
+file=/tmp/drift_mark4.ft
+
+cat > $file <<EOF2
+use io
+use http
+
+def (method: str, path: str, headers: <str, str>, body: str) hello -> str
+    ret "hello " + path
+end
+serve(listen("127.0.0.1", $port), hello)
+EOF2
+
+./drift $file &
+server=$!
+sleep 1
+
+python3 test/mark/mark4.py $port $conns $seconds 1
+python3 test/mark/mark4.py $port $conns $seconds $depth
+
+kill $server
+rm -f $file